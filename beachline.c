@@ -0,0 +1,492 @@
+/**
+ * @file beachline.c
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief beachline of the sweep, the boundaries are kept in a red-black tree
+ *        threaded in order, whose nodes embed them so that a search reads
+ *        the foci of every boundary it passes without chasing a pointer,
+ *        and compares them against the site with the exact breakpoint test
+ *        directly
+ * @version 0.1
+ * @date 2024-04-17
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "beachline.h"
+#include <stdlib.h>
+#include "pool.h"
+#include "predicates.h"
+#include "stats.h"
+
+#define RED 0
+#define BLACK 1
+
+struct beachline {
+    beach_node_t* root;
+    pool_t* node_pool;
+    beachline_stats_t stats;
+};
+
+/**
+ * @brief allocates a new node from the beachline's node pool, new nodes are
+ *        always red so that inserting them never changes black heights, its
+ *        boundary is left for the caller to fill in
+ * 
+ * @param tree beachline the node will belong to
+ * @return beach_node_t* the node, NULL if allocation fails
+ */
+beach_node_t* node_new(beachline_t* tree) {
+    beach_node_t* node;
+    if (!(node = pool_alloc(tree->node_pool))) {
+        return NULL;
+    }
+    node->right = NULL;
+    node->left = NULL;
+    node->parent = NULL;
+    node->prev = NULL;
+    node->next = NULL;
+    node->color = RED;
+    STAT(if (++tree->stats.size > tree->stats.max_size) {
+        tree->stats.max_size = tree->stats.size;
+    })
+    return node;
+}
+
+/**
+ * @brief allocates a new empty beachline, its nodes all come from a pool
+ *        owned by the beachline
+ * 
+ * @return beachline_t* the beachline, NULL if allocation fails
+ */
+beachline_t* beachline_new(void) {
+    beachline_t* tree;
+    if (!(tree = malloc(sizeof(beachline_t)))) {
+        return NULL;
+    }
+    if (!(tree->node_pool = pool_new(sizeof(beach_node_t)))) {
+        free(tree);
+        return NULL;
+    }
+    tree->root = NULL;
+    tree->stats = (beachline_stats_t) {0};
+    return tree;
+}
+
+/**
+ * @brief records a search that compared the site against depth nodes
+ * 
+ * @param tree 
+ * @param depth 
+ */
+void count_search(beachline_t* tree, int depth) {
+    tree->stats.searches++;
+    tree->stats.depth += depth;
+    if (depth > tree->stats.max_depth) tree->stats.max_depth = depth;
+}
+
+/* NULL children count as black leaves */
+#define NODE_COLOR(n) ((n) == NULL ? BLACK : (n)->color)
+
+beach_node_t* left_spine(beach_node_t* root) {
+    beach_node_t* target = root;
+    while (target->left != NULL) {
+        target = target->left;
+    }
+    return target;
+}
+
+beach_node_t* right_spine(beach_node_t* root) {
+    beach_node_t* target = root;
+    while(target->right != NULL) {
+        target = target->right;
+    }
+    return target;
+}
+
+/**
+ * @brief threads a node into the in-order list right after prev, a NULL 
+ *        prev means the node becomes the first in order
+ * 
+ * @param node node to be threaded
+ * @param prev in-order predecessor of the node
+ * @param next in-order successor of the node
+ */
+void node_link(beach_node_t* node, beach_node_t* prev, beach_node_t* next) {
+    node->prev = prev;
+    node->next = next;
+    if (prev != NULL) prev->next = node;
+    if (next != NULL) next->prev = node;
+}
+
+void node_unlink(beach_node_t* node) {
+    if (node->prev != NULL) node->prev->next = node->next;
+    if (node->next != NULL) node->next->prev = node->prev;
+}
+
+/**
+ * @brief replaces the subtree rooted at old with the subtree rooted at new,
+ *        only the link from old's parent is updated
+ * 
+ * @param tree tree containing old
+ * @param old node being replaced
+ * @param new node taking its place, may be NULL
+ */
+void beach_node_transplant(beachline_t* tree, beach_node_t* old, beach_node_t* new) {
+    if (old->parent == NULL) {
+        tree->root = new;
+    } else if (old == old->parent->left) {
+        old->parent->left = new;
+    } else {
+        old->parent->right = new;
+    }
+    if (new != NULL) new->parent = old->parent;
+}
+
+void node_rotate_left(beachline_t* tree, beach_node_t* node) {
+    beach_node_t* pivot = node->right;
+    node->right = pivot->left;
+    if (pivot->left != NULL) pivot->left->parent = node;
+    beach_node_transplant(tree, node, pivot);
+    pivot->left = node;
+    node->parent = pivot;
+}
+
+void node_rotate_right(beachline_t* tree, beach_node_t* node) {
+    beach_node_t* pivot = node->left;
+    node->left = pivot->right;
+    if (pivot->right != NULL) pivot->right->parent = node;
+    beach_node_transplant(tree, node, pivot);
+    pivot->right = node;
+    node->parent = pivot;
+}
+
+/**
+ * @brief restores the red-black invariants after a red node has been 
+ *        attached as a leaf
+ * 
+ * @param tree tree the node was inserted into
+ * @param node newly inserted node
+ */
+void insert_fixup(beachline_t* tree, beach_node_t* node) {
+    beach_node_t *parent, *grandparent, *uncle;
+
+    while ((parent = node->parent) != NULL && parent->color == RED) {
+        /* a red parent is never the root, so the grandparent exists */
+        grandparent = parent->parent;
+        if (parent == grandparent->left) {
+            uncle = grandparent->right;
+            if (NODE_COLOR(uncle) == RED) {
+                parent->color = BLACK;
+                uncle->color = BLACK;
+                grandparent->color = RED;
+                node = grandparent;
+                continue;
+            }
+            if (node == parent->right) {
+                node_rotate_left(tree, parent);
+                node = parent;
+                parent = node->parent;
+            }
+            parent->color = BLACK;
+            grandparent->color = RED;
+            node_rotate_right(tree, grandparent);
+        } else {
+            uncle = grandparent->left;
+            if (NODE_COLOR(uncle) == RED) {
+                parent->color = BLACK;
+                uncle->color = BLACK;
+                grandparent->color = RED;
+                node = grandparent;
+                continue;
+            }
+            if (node == parent->left) {
+                node_rotate_right(tree, parent);
+                node = parent;
+                parent = node->parent;
+            }
+            parent->color = BLACK;
+            grandparent->color = RED;
+            node_rotate_left(tree, grandparent);
+        }
+    }
+    tree->root->color = BLACK;
+}
+
+/**
+ * @brief restores the red-black invariants after a black node has been 
+ *        unlinked, node carries the extra black and may be NULL, which is
+ *        why its parent is tracked separately
+ * 
+ * @param tree tree the node was removed from
+ * @param node node that took the place of the removed node
+ * @param parent parent of node
+ */
+void delete_fixup(beachline_t* tree, beach_node_t* node, beach_node_t* parent) {
+    beach_node_t* sibling;
+
+    while (node != tree->root && NODE_COLOR(node) == BLACK) {
+        if (node == parent->left) {
+            sibling = parent->right;
+            if (sibling->color == RED) {
+                sibling->color = BLACK;
+                parent->color = RED;
+                node_rotate_left(tree, parent);
+                sibling = parent->right;
+            }
+            if (NODE_COLOR(sibling->left) == BLACK &&
+                NODE_COLOR(sibling->right) == BLACK) {
+                sibling->color = RED;
+                node = parent;
+                parent = node->parent;
+                continue;
+            }
+            if (NODE_COLOR(sibling->right) == BLACK) {
+                sibling->left->color = BLACK;
+                sibling->color = RED;
+                node_rotate_right(tree, sibling);
+                sibling = parent->right;
+            }
+            sibling->color = parent->color;
+            parent->color = BLACK;
+            sibling->right->color = BLACK;
+            node_rotate_left(tree, parent);
+        } else {
+            sibling = parent->left;
+            if (sibling->color == RED) {
+                sibling->color = BLACK;
+                parent->color = RED;
+                node_rotate_right(tree, parent);
+                sibling = parent->left;
+            }
+            if (NODE_COLOR(sibling->left) == BLACK &&
+                NODE_COLOR(sibling->right) == BLACK) {
+                sibling->color = RED;
+                node = parent;
+                parent = node->parent;
+                continue;
+            }
+            if (NODE_COLOR(sibling->left) == BLACK) {
+                sibling->right->color = BLACK;
+                sibling->color = RED;
+                node_rotate_left(tree, sibling);
+                sibling = parent->left;
+            }
+            sibling->color = parent->color;
+            parent->color = BLACK;
+            sibling->left->color = BLACK;
+            node_rotate_right(tree, parent);
+        }
+        node = tree->root;
+    }
+    if (node != NULL) node->color = BLACK;
+}
+
+/**
+ * @brief unlinks a node from the tree and rebalances, the node itself is 
+ *        relinked rather than having its boundary copied around, so 
+ *        pointers to the other nodes stay valid
+ * 
+ * @param tree tree containing the node
+ * @param target node to be removed
+ */
+void node_remove(beachline_t* tree, beach_node_t* target) {
+    beach_node_t *child, *child_parent, *successor;
+    char removed_color = target->color;
+
+    if (target->left == NULL) {
+        child = target->right;
+        child_parent = target->parent;
+        beach_node_transplant(tree, target, child);
+    } else if (target->right == NULL) {
+        child = target->left;
+        child_parent = target->parent;
+        beach_node_transplant(tree, target, child);
+    } else {
+        successor = left_spine(target->right);
+        removed_color = successor->color;
+        child = successor->right;
+        if (successor->parent == target) {
+            child_parent = successor;
+        } else {
+            child_parent = successor->parent;
+            beach_node_transplant(tree, successor, successor->right);
+            successor->right = target->right;
+            successor->right->parent = successor;
+        }
+        beach_node_transplant(tree, target, successor);
+        successor->left = target->left;
+        successor->left->parent = successor;
+        successor->color = target->color;
+    }
+
+    if (removed_color == BLACK) delete_fixup(tree, child, child_parent);
+    node_unlink(target);
+}
+
+/**
+ * @brief locates a site against the intersection of two arcs for the 
+ *        sweepline through the site, decided exactly, the site comes no 
+ *        earlier in sweep order than either focus
+ * 
+ * @param left focus of the arc to the left of the intersection
+ * @param right focus of the arc to the right of the intersection
+ * @param site site being located
+ * @return int -1 if the site lies to the left of the intersection, 1 if 
+ *         to its right and 0 if right underneath it
+ */
+int breakpoint_side(point_t* left, point_t* right, point_t* site) {
+    /* an arc whose focus is on the sweepline is a vertical ray up from it,
+       and two arcs of equally high foci meet halfway between them */
+    if (left->y == site->y && right->y == site->y) {
+        return midpoint_compare(site->x, left->x, right->x);
+    }
+    if (left->y == site->y) return SIGN(site->x - left->x);
+    if (right->y == site->y) return SIGN(site->x - right->x);
+    if (left->y == right->y) {
+        return midpoint_compare(site->x, left->x, right->x);
+    }
+
+    /* otherwise the arcs meet twice and the lower focus has the narrower
+       arc, which is the lower one between the two intersections, if the 
+       left arc is the wider one the boundary is the left intersection, 
+       which lies left of the right focus, and the site is left of it iff 
+       the left arc is the lower one above the site, and symmetrically */
+    if (left->y > right->y) {
+        if (site->x >= right->x) return 1;
+    } else if (site->x <= left->x) {
+        return -1;
+    }
+    return SIGN(incircle_tangent(left, right, site));
+}
+
+/**
+ * @brief locates where a site lies on the beachline in a single descent
+ * 
+ * @param tree beachline to be searched
+ * @param site site being located, for the sweepline through it
+ * @param leftp set to the node of the boundary right above the site if 
+ *              found, otherwise to the closest boundary on its left (NULL 
+ *              if none)
+ * @param rightp set to the node of the boundary right above the site if 
+ *               found, otherwise to the closest boundary on its right 
+ *               (NULL if none)
+ * @return int KEY_FOUND if the site lies right underneath a boundary, 
+ *         KEY_NOT_FOUND otherwise
+ */
+int beachline_locate(beachline_t* tree, point_t* site, beach_node_t** leftp,
+                     beach_node_t** rightp) {
+    beach_node_t* target = tree->root;
+    int side;
+    STAT(int depth = 0);
+    *leftp = NULL;
+    *rightp = NULL;
+    while (target && (side = breakpoint_side(&target->bound.left_point,
+                                             &target->bound.right_point,
+                                             site)) != 0) {
+        STAT(depth++);
+        if (side < 0) {
+            *rightp = target;
+            target = target->left;
+        } else {
+            *leftp = target;
+            target = target->right;
+        }
+    }
+    STAT(count_search(tree, depth + (target != NULL)));
+    if (target) {
+        *leftp = target;
+        *rightp = target;
+        return KEY_FOUND;
+    }
+    return KEY_NOT_FOUND;
+}
+
+/**
+ * @brief inserts a new boundary directly after a given node in order, the 
+ *        caller fills in the boundary and guarantees it belongs there
+ * 
+ * @param tree beachline to insert into
+ * @param pos node that will precede the new node, NULL to insert first
+ * @return beach_node_t* the new node, NULL if allocation fails
+ */
+beach_node_t* beachline_insert_after(beachline_t* tree, beach_node_t* pos) {
+    beach_node_t *node, *next;
+
+    if (!(node = node_new(tree))) return NULL;
+
+    next = pos ? pos->next : (tree->root ? left_spine(tree->root) : NULL);
+    if (pos != NULL && pos->right == NULL) {
+        pos->right = node;
+        node->parent = pos;
+    } else if (next != NULL) {
+        /* the successor is the leftmost node of pos's right subtree, 
+           or the first node overall, either way its left slot is free */
+        next->left = node;
+        node->parent = next;
+    } else {
+        tree->root = node;
+    }
+    node_link(node, pos, next);
+    insert_fixup(tree, node);
+    return node;
+}
+
+/**
+ * @brief removes a node from the beachline and returns it to the pool
+ * 
+ * @param tree beachline containing the node
+ * @param node node to be removed
+ */
+void beachline_remove(beachline_t* tree, beach_node_t* node) {
+    node_remove(tree, node);
+    pool_release(tree->node_pool, node);
+    STAT(tree->stats.size--);
+}
+
+/**
+ * @brief returns the first node in order
+ * 
+ * @param tree 
+ * @return beach_node_t* the first node, NULL if the beachline is empty
+ */
+beach_node_t* beachline_first(beachline_t* tree) {
+    if (tree->root == NULL) return NULL;
+    return left_spine(tree->root);
+}
+
+/**
+ * @brief removes every node from the beachline, the node pool keeps its 
+ *        blocks so that refilling the beachline does not allocate
+ * 
+ * @param tree 
+ */
+void beachline_clear(beachline_t* tree) {
+    pool_reset(tree->node_pool);
+    tree->root = NULL;
+    tree->stats = (beachline_stats_t) {0};
+}
+
+/**
+ * @brief frees the beachline, all nodes are released in one go along with 
+ *        the node pool
+ * 
+ * @param tree 
+ */
+void beachline_free(beachline_t* tree) {
+    pool_free(tree->node_pool);
+    free(tree);
+}
+
+/**
+ * @brief reports the searches through a beachline and its size since it 
+ *        was created or cleared
+ * 
+ * @param tree 
+ * @param stats struct to which the counters are written, all 0 without 
+ *              VORONOI_STATS
+ */
+void beachline_stats(beachline_t* tree, beachline_stats_t* stats) {
+    *stats = tree->stats;
+    stats->allocations = pool_allocations(tree->node_pool);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file beachline.h
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief beachline of the sweep, a red-black tree of the boundaries between
+ *        its arcs whose nodes hold the boundaries themselves
+ * @version 0.1
+ * @date 2024-04-17
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef _BEACHLINE_H_
+#define _BEACHLINE_H_
+#include "geometry.h"
+
+#define KEY_FOUND 1
+#define KEY_NOT_FOUND 0
+
+struct event;
+struct beachline;
+
+/* intersection of two neighbouring arcs of the beachline, the arc of
+   left_point lies to its left and that of right_point to its right */
+struct boundary {
+    point_t left_point;
+    point_t right_point;
+    /* pending circle event of the arc to the right of this boundary */
+    struct event* circle_event;
+    /* indices of the input points of the two sites */
+    int left_site;
+    int right_site;
+    /* index of the voronoi edge traced by this boundary */
+    int edge;
+};
+
+/* node of the beachline, only bound, prev and next are meant to be used
+   outside of the tree, a node stays valid until it is removed */
+struct beach_node {
+    struct boundary bound;
+    /* neighbouring boundaries in order, NULL at either end */
+    struct beach_node* prev;
+    struct beach_node* next;
+    struct beach_node* left;
+    struct beach_node* right;
+    struct beach_node* parent;
+    char color;
+};
+
+/* searches through a beachline and its size since it was created or
+   cleared, only counted by builds with VORONOI_STATS */
+struct beachline_stats {
+    long searches;
+    /* boundaries compared against over all searches */
+    long depth;
+    int max_depth;
+    int size;
+    int max_size;
+    /* nodes taken from the node pool */
+    long allocations;
+};
+
+typedef struct boundary boundary_t;
+typedef struct beach_node beach_node_t;
+typedef struct beachline beachline_t;
+typedef struct beachline_stats beachline_stats_t;
+
+beachline_t* beachline_new(void);
+
+int breakpoint_side(point_t* left, point_t* right, point_t* site);
+
+int beachline_locate(beachline_t* beachline, point_t* site,
+                     beach_node_t** leftp, beach_node_t** rightp);
+
+beach_node_t* beachline_insert_after(beachline_t* beachline,
+                                     beach_node_t* pos);
+
+void beachline_remove(beachline_t* beachline, beach_node_t* node);
+
+beach_node_t* beachline_first(beachline_t* beachline);
+
+void beachline_clear(beachline_t* beachline);
+
+void beachline_free(beachline_t* beachline);
+
+void beachline_stats(beachline_t* beachline, beachline_stats_t* stats);
+
+#endif
@@ -0,0 +1,172 @@
+/**
+ * @file binary.c
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief reads and writes the binary formats of the voronoi executable, 
+ *        sites are mapped straight from their file and diagrams are 
+ *        written as whole arrays
+ * @version 0.1
+ * @date 2024-04-02
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "binary.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* number of edges gathered before every write */
+#define BINARY_CHUNK 65536
+
+int host_little_endian(void) {
+    uint16_t one = 1;
+    return *(uint8_t*) &one;
+}
+
+/**
+ * @brief reverses the bytes of every element of an array in place
+ * 
+ * @param data 
+ * @param size size of an element
+ * @param count number of elements
+ */
+void swap_bytes(void* data, size_t size, size_t count) {
+    uint8_t *p = (uint8_t*) data, temp;
+    for (size_t i = 0; i < count; i++, p += size) {
+        for (size_t j = 0; j < size / 2; j++) {
+            temp = p[j];
+            p[j] = p[size - 1 - j];
+            p[size - 1 - j] = temp;
+        }
+    }
+}
+
+/**
+ * @brief writes an array in little-endian order, the array is swapped in 
+ *        place and back on big-endian hosts
+ * 
+ * @param out 
+ * @param data 
+ * @param size size of an element
+ * @param count number of elements
+ * @return int 0 on success, -1 on failure
+ */
+int write_le(FILE* out, void* data, size_t size, size_t count) {
+    int status;
+    if (!host_little_endian()) swap_bytes(data, size, count);
+    status = fwrite(data, size, count, out) == count ? 0 : -1;
+    if (!host_little_endian()) swap_bytes(data, size, count);
+    return status;
+}
+
+/**
+ * @brief maps a sites file into memory
+ * 
+ * @param sites struct to which the mapping is written
+ * @param filename path to the sites file
+ * @return int 0 on success, -1 if the file could not be mapped or is not a
+ *         valid sites file
+ */
+int binary_map_sites(binary_sites_t* sites, char* filename) {
+    binary_header_t header;
+    struct stat st;
+    point_t* points;
+    int fd;
+
+    memset(sites, 0, sizeof(binary_sites_t));
+    if ((fd = open(filename, O_RDONLY)) < 0) return -1;
+    if (fstat(fd, &st) || st.st_size < (off_t) sizeof(binary_header_t)) {
+        close(fd);
+        return -1;
+    }
+    sites->length = st.st_size;
+    sites->addr = mmap(NULL, sites->length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (sites->addr == MAP_FAILED) {
+        sites->addr = NULL;
+        return -1;
+    }
+
+    memcpy(&header, sites->addr, sizeof(binary_header_t));
+    if (!host_little_endian()) swap_bytes(&header.version, 4, 1);
+    if (!host_little_endian()) swap_bytes(header.count, 8, 3);
+    if (memcmp(header.magic, BINARY_SITES_MAGIC, 4) ||
+        header.version != BINARY_VERSION || header.count[0] > INT_MAX ||
+        sites->length != sizeof(binary_header_t) +
+                         header.count[0] * sizeof(point_t)) {
+        binary_unmap_sites(sites);
+        return -1;
+    }
+    sites->npoints = header.count[0];
+    sites->points = (point_t*) ((char*) sites->addr + 
+                                sizeof(binary_header_t));
+    if (host_little_endian()) return 0;
+
+    /* the mapping cannot be read in place, so it is swapped into a copy */
+    if (!(points = malloc((sites->npoints + 1) * sizeof(point_t)))) {
+        binary_unmap_sites(sites);
+        return -1;
+    }
+    memcpy(points, sites->points, sites->npoints * sizeof(point_t));
+    swap_bytes(points, sizeof(double), 2 * sites->npoints);
+    munmap(sites->addr, sites->length);
+    sites->addr = NULL;
+    sites->points = points;
+    return 0;
+}
+
+void binary_unmap_sites(binary_sites_t* sites) {
+    if (sites->addr) munmap(sites->addr, sites->length);
+    else free(sites->points);
+    memset(sites, 0, sizeof(binary_sites_t));
+}
+
+/**
+ * @brief writes a diagram file, the int32 pairs of the edges are gathered
+ *        from the half-edges a chunk at a time
+ * 
+ * @param out 
+ * @param points sites of the diagram
+ * @param npoints number of sites
+ * @param dcel topology of the diagram
+ * @return int 0 on success, -1 on failure
+ */
+int binary_write_diagram(FILE* out, point_t* points, int npoints,
+                         voronoi_dcel_t* dcel) {
+    binary_header_t header;
+    int32_t* chunk;
+    int nedges = dcel->nhalfedges / 2, n, status = 0;
+
+    memcpy(header.magic, BINARY_DIAGRAM_MAGIC, 4);
+    header.version = BINARY_VERSION;
+    header.count[0] = npoints;
+    header.count[1] = dcel->nvertices;
+    header.count[2] = nedges;
+    if (!host_little_endian()) swap_bytes(&header.version, 4, 1);
+    if (!host_little_endian()) swap_bytes(header.count, 8, 3);
+    if (fwrite(&header, sizeof(binary_header_t), 1, out) != 1 ||
+        write_le(out, points, sizeof(double), 2 * npoints) ||
+        write_le(out, dcel->vertices, sizeof(double), 2 * dcel->nvertices)) {
+        return -1;
+    }
+
+    if (!(chunk = malloc(2 * BINARY_CHUNK * sizeof(int32_t)))) return -1;
+    /* the vertex pairs of all edges come first, then their site pairs */
+    for (int pass = 0; pass < 2 && !status; pass++) {
+        for (int e = 0; e < nedges && !status; e += BINARY_CHUNK) {
+            n = nedges - e < BINARY_CHUNK ? nedges - e : BINARY_CHUNK;
+            for (int i = 0; i < 2 * n; i++) {
+                voronoi_halfedge_t* half = &dcel->halfedges[2 * e + i];
+                chunk[i] = pass ? half->cell : half->origin;
+            }
+            status = write_le(out, chunk, sizeof(int32_t), 2 * n);
+        }
+    }
+    free(chunk);
+    return status;
+}
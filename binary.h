@@ -0,0 +1,54 @@
+/**
+ * @file binary.h
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief 
+ * @version 0.1
+ * @date 2024-04-02
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef _BINARY_H_
+#define _BINARY_H_
+#include <stdint.h>
+#include <stdio.h>
+#include "geometry.h"
+#include "voronoi.h"
+
+#define BINARY_SITES_MAGIC "VSIT"
+#define BINARY_DIAGRAM_MAGIC "VDGM"
+#define BINARY_VERSION 1
+
+/* header of both binary formats, which are little-endian throughout, a 
+   sites file holds count[0] sites as (x, y) float64 pairs, a diagram file
+   holds count[0] sites and count[1] vertices as (x, y) float64 pairs, 
+   followed by count[2] edges as (v1, v2) int32 pairs of vertex indices, 
+   -1 at an infinite end, and then the (s1, s2) int32 pairs of the sites 
+   every edge separates */
+struct binary_header {
+    char magic[4];
+    uint32_t version;
+    uint64_t count[3];
+};
+
+/* sites file mapped into memory, the points are read in place unless the
+   host is big-endian */
+struct binary_sites {
+    void* addr;
+    size_t length;
+    point_t* points;
+    int npoints;
+};
+
+typedef struct binary_header binary_header_t;
+typedef struct binary_sites binary_sites_t;
+
+int binary_map_sites(binary_sites_t* sites, char* filename);
+
+void binary_unmap_sites(binary_sites_t* sites);
+
+int binary_write_diagram(FILE* out, point_t* points, int npoints,
+                         voronoi_dcel_t* dcel);
+
+#endif
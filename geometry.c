@@ -10,6 +10,7 @@
  */
 
 #include "geometry.h"
+#include "predicates.h"
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -23,28 +24,17 @@ int point_equality(point_t* p1, point_t* p2) {
     return p1->x == p2->x && p1->y == p2->y;
 }
 
-int point_compare(point_t* p1, point_t* p2) {
-    int comp;
-    if ((comp = ASYM_COMPARE(p1->y, p2->y))) return comp;
-    return ASYM_COMPARE(p1->x, p2->x);
-}
-
 void point_copy(point_t* src, point_t* dest) {
     dest->x = src->x;
     dest->y = src->y;
 }
 
-segment_t* segment_new(line_t* source_line, point_t* dp1, point_t* dp2) {
-    segment_t* seg;
-    if (!(seg = malloc(sizeof(segment_t)))) return NULL;
+void segment_init(segment_t* seg, line_t* source_line, int site1, int site2) {
     seg->label = SEG_LINE;
     seg->options.line.intercept = source_line->intercept;
     seg->options.line.gradient = source_line->gradient;
-    seg->dual.p1.x = dp1->x;
-    seg->dual.p1.y = dp1->y;
-    seg->dual.p2.x = dp2->x;
-    seg->dual.p2.y = dp2->y;
-    return seg;
+    seg->dual.site1 = site1;
+    seg->dual.site2 = site2;
 }
 
 void segment_transform(segment_t* seg, point_t* point) {
@@ -71,7 +61,15 @@ void segment_ray2seg(segment_t* seg, point_t* point) {
     seg->options.seg.p2.y = point->y;
 }
 
-void segment_print(segment_t* seg) {
+/**
+ * @brief prints a segment along with its dual
+ * 
+ * @param seg 
+ * @param sites input points the dual indexes into
+ */
+void segment_print(segment_t* seg, point_t* sites) {
+    point_t* p1 = &sites[seg->dual.site1];
+    point_t* p2 = &sites[seg->dual.site2];
     switch (seg->label) {
         case SEG_LINE:
             printf("LINE ");
@@ -79,116 +77,12 @@ void segment_print(segment_t* seg) {
                     seg->options.line.intercept);
             break;
         case SEG_RAY:
-            printf("[[%f, %f], [%f, %f]], ", seg->dual.p1.x, 
-                  seg->dual.p1.y, seg->dual.p2.x,
-                   seg->dual.p2.y);
         case SEG_SEG:
-            printf("[[%f, %f], [%f, %f]], ", seg->dual.p1.x, 
-                  seg->dual.p1.y, seg->dual.p2.x,
-              seg->dual.p2.y);
+            printf("[[%f, %f], [%f, %f]], ", p1->x, p1->y, p2->x, p2->y);
           break;
     }
 }
 
-void segment_free(segment_t* seg) {
-    free(seg);
-}
-
-
-/**
- * @brief An arbitrary compare function to facilitate insertion into BST
- * 
- * @param s1 
- * @param s2 
- * @return int 
- */
-int segment_compare(void* s1, void* s2, void* arg) {
-    segment_t* seg1 = (segment_t*) s1;
-    segment_t* seg2 = (segment_t*) s2;
-    int comp;
-  //  printf("COMP\n");
-  //  segment_print(s1);
-  //  segment_print(s2);
-    if ((comp = ASYM_COMPARE(seg1->label, seg2->label))) {
-       // printf(" %d\n", comp);
-        return comp;}
-    if (seg1->label == SEG_LINE) {
-        if ((comp = ASYM_COMPARE(seg1->options.line.intercept,
-                                 seg2->options.line.intercept))) return comp;
-        return ASYM_COMPARE(seg1->options.line.gradient,
-                            seg2->options.line.gradient);                         
-    } else if (seg1->label == SEG_RAY) {
-        if ((comp = point_compare(&seg1->options.ray.p,
-                                  &seg2->options.ray.p))) return comp;
-        return ASYM_COMPARE(seg1->options.ray.gradient,
-                            seg2->options.ray.gradient);  
-    } else {
-        if ((comp = point_compare(&seg1->options.seg.p1,
-                                  &seg2->options.seg.p1))) return comp;
-        return point_compare(&seg1->options.seg.p2,
-                            &seg2->options.seg.p2);
-    }
-
-}
-
-double compute_parabola_value(point_t* focus, double sweep, double x) {
-    double x_prime = x - focus->x;
-    x_prime *= x_prime;
-    x_prime += focus->y*focus->y;
-    x_prime -= sweep*sweep;
-    return x_prime / (2 * (focus->y - sweep));
-}
-
-int compute_arc_intersection(point_t *left, point_t *right, double sweep,
-                              point_t *res) {
-    double del_yl, del_yr;
-    double al, bl, cl;
-    double a, b, c;
-    double determinant;
-    circle_t circle;
-    point_t mid;
-
-    if (left->y == right->y && left->y == sweep) {
-        res->x = (left->x + right->x) / 2;
-        res->y = 1e+8;
-        return 0;
-    } else if (left->y == sweep) {
-        res->x = left->x;
-        res->y = compute_parabola_value(right, sweep, left->x);
-        return 0;
-    } else if (right->y == sweep) {
-        res->x = right->x;
-        res->y = compute_parabola_value(right, sweep, right->x);
-        return 0;
-    }
-
-    del_yl = left->y - sweep;
-    del_yr = right->y - sweep;
-    if (del_yl <= 0)  del_yl += 1e-6;
-    if (del_yr <= 0) del_yr += 1e-6;
-
-    if (del_yl == del_yr) {
-        mid.y = sweep;
-        mid.x = (right->x + left->x) / 2;
-        compute_circumcircle(left, right, &mid, &circle);
-        res->x = circle.center.x;
-        res->y = circle.center.y;    
-        return 0;
-    }
-
-    /* computing the coefficients of the quadratic equation */
-    al = (0.5 / del_yl);
-    a = al - (0.5 / del_yr);
-    bl = - (left->x / del_yl);
-    b = (right->x / del_yr) + bl;
-    cl = (left->x*left->x + left->y*left->y - sweep*sweep) / (2*del_yl);
-    c =  cl - (right->x*right->x + right->y*right->y - sweep*sweep) / (2*del_yr);
-    if ((determinant = b*b - 4*a*c) < 0) return -1;
-    res->x = (-b + sqrt(determinant)) / (2*a);
-    res->y = al*(res->x*res->x) + bl*res->x + cl;
-    return 0;
-}
-
 double compute_gradient(point_t *p1, point_t *p2) {
     double delta_x = p2->x - p1->x;
     double delta_y = p2->y - p1->y;
@@ -240,20 +134,20 @@ int solve_linear(line_t *l1, line_t *l2, point_t *res) {
     return 0; /* one unique solution */
 }
 
-int compute_circumcircle(point_t *p1, point_t *p2, point_t *p3, circle_t *res) {
+/**
+ * @brief computes the circle through three points, whatever their order
+ * 
+ * @param p1 
+ * @param p2 
+ * @param p3 
+ * @param res 
+ * @return int 0 on success, nonzero if the points are collinear
+ */
+int compute_circumcenter(point_t *p1, point_t *p2, point_t *p3, circle_t *res) {
     line_t l1, l2;
     point_t center;
     int retval;
 
-
-    point_t v1, v2;
-    v1.x = p1->x - p2->x;
-    v1.y = p1->y - p2->y;
-    v2.x = p3->x - p2->x;
-    v2.y = p3->y - p2->y;
-    double ang = atan2(v2.y*v1.x - v2.x*v1.y, v1.x*v2.x + v1.y*v2.y);
-    if (ang <= 0) return -1;
-
     compute_bisector(p1, p2, &l1);
     compute_bisector(p2, p3, &l2);
     if ((retval = solve_linear(&l1, &l2, &center))) return retval;
@@ -263,12 +157,147 @@ int compute_circumcircle(point_t *p1, point_t *p2, point_t *p3, circle_t *res) {
     return 0;
 }
 
-int compute_circle_tangent(point_t *p1, point_t *p2, point_t *p3, point_t* res) {
-    circle_t circle;
-    int retval; 
-    if ((retval = compute_circumcircle(p1, p2, p3, &circle))) return retval;
-    res->x = circle.center.x;
-    res->y = circle.center.y - circle.radius;
+/**
+ * @brief computes the circle through three points that come in clockwise
+ *        order, i.e. whose arcs on the beachline have converging 
+ *        boundaries, the order is decided exactly
+ * 
+ * @param p1 
+ * @param p2 
+ * @param p3 
+ * @param res 
+ * @return int 0 on success, nonzero if the points are not in clockwise 
+ *         order
+ */
+int compute_circumcircle(point_t *p1, point_t *p2, point_t *p3, circle_t *res) {
+    if (orient2d(p1, p2, p3) >= 0) return -1;
+    return compute_circumcenter(p1, p2, p3, res);
+}
+
+
+/**
+ * @brief clips the part of a line between two parameters to a rectangle 
+ *        (Liang-Barsky)
+ * 
+ * @param box rectangle clipped to
+ * @param origin point of the line at parameter 0
+ * @param dir direction of the line, the point at parameter t being 
+ *            origin + t * dir
+ * @param t0 lower parameter, -INFINITY for no bound, raised to where the 
+ *           line enters the rectangle
+ * @param t1 upper parameter, INFINITY for no bound, lowered to where the 
+ *           line leaves the rectangle
+ * @return int 0 if some of the line lies in the rectangle, -1 otherwise
+ */
+int clip_line(box_t* box, point_t* origin, point_t* dir, double* t0,
+              double* t1) {
+    double p[4] = {-dir->x, dir->x, -dir->y, dir->y};
+    double q[4] = {origin->x - box->xmin, box->xmax - origin->x,
+                   origin->y - box->ymin, box->ymax - origin->y};
+    double t;
+
+    for (int i = 0; i < 4; i++) {
+        if (p[i] == 0) {
+            /* parallel to this side of the rectangle */
+            if (q[i] < 0) return -1;
+            continue;
+        }
+        t = q[i] / p[i];
+        if (p[i] < 0) {
+            if (t > *t1) return -1;
+            if (t > *t0) *t0 = t;
+        } else {
+            if (t < *t0) return -1;
+            if (t < *t1) *t1 = t;
+        }
+    }
     return 0;
 }
 
+/**
+ * @brief moves a point where a line leaves a rectangle onto the nearest 
+ *        side of the rectangle, so that rounding leaves it neither inside 
+ *        nor outside
+ * 
+ * @param box rectangle
+ * @param p point snapped in place
+ */
+void box_snap(box_t* box, point_t* p) {
+    double d[4];
+    int side = 0;
+
+    p->x = fmin(fmax(p->x, box->xmin), box->xmax);
+    p->y = fmin(fmax(p->y, box->ymin), box->ymax);
+    d[0] = p->x - box->xmin;
+    d[1] = box->xmax - p->x;
+    d[2] = p->y - box->ymin;
+    d[3] = box->ymax - p->y;
+    for (int i = 1; i < 4; i++) {
+        if (d[i] < d[side]) side = i;
+    }
+    switch (side) {
+        case 0: p->x = box->xmin; break;
+        case 1: p->x = box->xmax; break;
+        case 2: p->y = box->ymin; break;
+        default: p->y = box->ymax;
+    }
+}
+
+/**
+ * @brief clips a line, ray or segment to a rectangle, ends that lie in the
+ *        rectangle are kept exactly, those it cuts lie on its sides
+ * 
+ * @param seg edge clipped in place, it becomes a segment running along the
+ *            direction of the line or ray, or SEG_OUTSIDE with NaN points
+ *            if none of it lies in the rectangle
+ * @param box rectangle clipped to
+ * @param point some point of a line, ignored otherwise
+ * @param dir direction of a line or ray, ignored for a segment
+ */
+void segment_clip(segment_t* seg, box_t* box, point_t* point, point_t* dir) {
+    double t0 = 0, t1 = INFINITY;
+    point_t origin, delta, p1, p2;
+
+    switch (seg->label) {
+        case SEG_LINE:
+            t0 = -INFINITY;
+            point_copy(point, &origin);
+            point_copy(dir, &delta);
+            break;
+        case SEG_RAY:
+            point_copy(RAY_POINT(seg), &origin);
+            point_copy(dir, &delta);
+            break;
+        case SEG_SEG:
+            t1 = 1;
+            point_copy(SEG_POINT1(seg), &origin);
+            delta.x = SEG_POINT2(seg)->x - origin.x;
+            delta.y = SEG_POINT2(seg)->y - origin.y;
+            break;
+        default:
+            return;
+    }
+    if (clip_line(box, &origin, &delta, &t0, &t1)) {
+        seg->label = SEG_OUTSIDE;
+        SEG_POINT1(seg)->x = SEG_POINT1(seg)->y = NAN;
+        SEG_POINT2(seg)->x = SEG_POINT2(seg)->y = NAN;
+        return;
+    }
+    if (t0 == 0) {
+        point_copy(&origin, &p1);
+    } else {
+        p1.x = origin.x + t0 * delta.x;
+        p1.y = origin.y + t0 * delta.y;
+        box_snap(box, &p1);
+    }
+    if (t1 == 1 && seg->label == SEG_SEG) {
+        point_copy(SEG_POINT2(seg), &p2);
+    } else {
+        p2.x = origin.x + t1 * delta.x;
+        p2.y = origin.y + t1 * delta.y;
+        box_snap(box, &p2);
+    }
+    seg->label = SEG_SEG;
+    point_copy(&p1, SEG_POINT1(seg));
+    point_copy(&p2, SEG_POINT2(seg));
+}
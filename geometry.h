@@ -15,6 +15,8 @@
 #define SEG_LINE 0
 #define SEG_RAY 1
 #define SEG_SEG 2
+/* an edge lying entirely outside the clip rectangle */
+#define SEG_OUTSIDE 3
 
 #define RAY_GRADIENT(sg) (sg->options.ray.gradient)
 #define RAY_POINT(sg) (&sg->options.ray.p)
@@ -23,8 +25,6 @@
 #define SEG_POINT1(sg) (&sg->options.seg.p1)
 #define SEG_POINT2(sg) (&sg->options.seg.p2)
 
-#define ASYM_COMPARE(l1, l2) (2*((l1) < (l2)) + (((l1) == (l2)) - 1))
-
 struct point {
     double x;
     double y;
@@ -40,6 +40,14 @@ struct line {
     double intercept;
 };
 
+/* axis-aligned rectangle, with xmin <= xmax and ymin <= ymax */
+struct box {
+    double xmin;
+    double ymin;
+    double xmax;
+    double ymax;
+};
+
 struct segment {
     char label;
     union {
@@ -53,15 +61,18 @@ struct segment {
             struct point p2;
         } seg;
     } options;
+    /* indices of the input points of the two sites whose bisector this 
+       is, the dual delaunay edge */
     struct {
-        struct point p1;
-        struct point p2;
+        int site1;
+        int site2;
     } dual;
 };
 
 typedef struct point point_t;
 typedef struct circle circle_t;
 typedef struct line line_t;
+typedef struct box box_t;
 typedef struct segment segment_t;
 void point_print(point_t* p, char* arg);
 
@@ -69,9 +80,9 @@ int point_equality(point_t* p1, point_t* p2);
 
 void point_copy(point_t* src, point_t* dest);
 
-segment_t* segment_new(line_t* source_line, point_t* dp1, point_t* dp2);
+void segment_init(segment_t* seg, line_t* source_line, int site1, int site2);
 
-void segment_print(segment_t* seg);
+void segment_print(segment_t* seg, point_t* sites);
 
 void segment_transform(segment_t* seg, point_t* point);
 
@@ -79,21 +90,17 @@ void segment_line2ray(segment_t* seg, point_t* point);
 
 void segment_ray2seg(segment_t* seg, point_t* point);
 
-int segment_compare(void* s1, void* s2, void* arg);
-
-void segment_free(segment_t* seg);
-
-double compute_parabola_value(point_t* focus, double sweep, double x);
-
-int compute_arc_intersection(point_t *left, point_t *right, double sweep,
-                              point_t *res);
-
 void compute_bisector(point_t *p1, point_t *p2, line_t *res);
 
 void compute_midpoint(point_t *p1, point_t *p2, point_t *res);
 
+int compute_circumcenter(point_t *p1, point_t *p2, point_t *p3, circle_t *res);
+
 int compute_circumcircle(point_t *p1, point_t *p2, point_t *p3, circle_t *res);
 
-int compute_circle_tangent(point_t *p1, point_t *p2, point_t *p3, point_t* res);
+int clip_line(box_t* box, point_t* origin, point_t* dir, double* t0,
+              double* t1);
+
+void segment_clip(segment_t* seg, box_t* box, point_t* point, point_t* dir);
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,478 @@
+/**
+ * @file merge.c
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief merges the voronoi diagrams of two sets of sites separated by a
+ *        vertical line, by walking the chain of bisectors dividing them
+ *        from the bottom to the top through the cells of both diagrams
+ * @version 0.1
+ * @date 2024-03-24
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "merge.h"
+#include "predicates.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* incident half-edges of every cell of a partial diagram, those of site s
+   are halves[start[s - lo]] up to halves[start[s - lo + 1]], a half-edge
+   being 2*edge + side */
+struct cells {
+    int* start;
+    int* halves;
+};
+
+/* the dividing chain, its edges are part_edge_t whose left site lies in
+   the left diagram */
+struct chain {
+    point_t* vertices;
+    int nvertices;
+    part_edge_t* edges;
+    int nedges;
+    int size;
+};
+
+typedef struct cells cells_t;
+typedef struct chain chain_t;
+
+void cells_free(cells_t* cells) {
+    free(cells->start);
+    free(cells->halves);
+}
+
+/**
+ * @brief groups the half-edges of a partial diagram by cell
+ *
+ * @param cells
+ * @param part
+ * @return int 0 on success, -1 if allocation failed
+ */
+int cells_build(cells_t* cells, part_t* part) {
+    int nsites = part->hi - part->lo;
+    int site;
+    cells->start = calloc(nsites + 1, sizeof(int));
+    cells->halves = malloc((2 * part->nedges + 1) * sizeof(int));
+    if (!cells->start || !cells->halves) {
+        cells_free(cells);
+        return -1;
+    }
+    for (int e = 0; e < part->nedges; e++) {
+        cells->start[part->edges[e].site[0] - part->lo + 1]++;
+        cells->start[part->edges[e].site[1] - part->lo + 1]++;
+    }
+    for (int s = 0; s < nsites; s++) cells->start[s + 1] += cells->start[s];
+    /* every cell is filled from its start, which leaves start[s] at the
+       start of the next cell, so the starts are shifted back afterwards */
+    for (int h = 0; h < 2 * part->nedges; h++) {
+        site = part->edges[h >> 1].site[h & 1] - part->lo;
+        cells->halves[cells->start[site]++] = h;
+    }
+    for (int s = nsites; s > 0; s--) cells->start[s] = cells->start[s - 1];
+    cells->start[0] = 0;
+    return 0;
+}
+
+/**
+ * @brief tests whether a neighbour of a site of the chain comes before 
+ *        another going around the site away from the current bisector, 
+ *        counterclockwise for a site of the left diagram and clockwise for
+ *        one of the right diagram
+ *
+ * @param s site of the chain
+ * @param x
+ * @param y
+ * @param right 1 if s lies in the right diagram, 0 otherwise
+ * @return int
+ */
+int turns_first(point_t* s, point_t* x, point_t* y, int right) {
+    double o = orient2d(s, x, y);
+    return right ? o < 0 : o > 0;
+}
+
+/**
+ * @brief finds the neighbour a site of the chain hands over to on its 
+ *        side, the bisector of l and r leaves the cell of the site through
+ *        the edge to the neighbour above the line from l to r whose circle 
+ *        through l and r it reaches first, where several share that circle
+ *        the first around the site is taken, and the edges to the 
+ *        neighbours before it around the site, whose circles hold it, are
+ *        dropped (Guibas and Stolfi, "Primitives for the Manipulation of
+ *        General Subdivisions and the Computation of Voronoi Diagrams")
+ *
+ * @param part diagram of the side
+ * @param cells cells of the diagram
+ * @param sites sorted sites
+ * @param l left site of the current bisector
+ * @param r right site of the current bisector
+ * @param right 0 for the side of l, 1 for that of r
+ * @param dropped flags of the edges of the diagram that no longer belong 
+ *                to it
+ * @return int half-edge of the cell of the site to the neighbour, -1 if 
+ *         the bisector never leaves the cell
+ */
+int next_candidate(part_t* part, cells_t* cells, point_t* sites, int l,
+                   int r, int right, char* dropped) {
+    int site = (right ? r : l) - part->lo;
+    int best = -1, h, x, y = -1;
+    double in;
+
+    for (int k = cells->start[site]; k < cells->start[site + 1]; k++) {
+        h = cells->halves[k];
+        if (dropped[h >> 1]) continue;
+        x = part->edges[h >> 1].site[!(h & 1)];
+        if (orient2d(&sites[l], &sites[r], &sites[x]) <= 0) continue;
+        if (best >= 0) {
+            in = incircle(&sites[l], &sites[r], &sites[y], &sites[x]);
+            if (in < 0 || (in == 0 && !turns_first(&sites[site + part->lo],
+                                                   &sites[x], &sites[y],
+                                                   right))) continue;
+        }
+        best = h;
+        y = x;
+    }
+    if (best < 0) return -1;
+    for (int k = cells->start[site]; k < cells->start[site + 1]; k++) {
+        h = cells->halves[k];
+        x = part->edges[h >> 1].site[!(h & 1)];
+        if (orient2d(&sites[l], &sites[r], &sites[x]) > 0 &&
+            turns_first(&sites[site + part->lo], &sites[x], &sites[y],
+                        right)) dropped[h >> 1] = 1;
+    }
+    return best;
+}
+
+/**
+ * @brief computes the lower convex hull of a range of sorted sites
+ *
+ * @param sites sorted sites
+ * @param lo first site
+ * @param hi end of the range
+ * @param hull array of at least hi - lo entries, to which the hull is
+ *             written from left to right
+ * @return int number of sites on the hull
+ */
+int lower_hull(point_t* sites, int lo, int hi, int* hull) {
+    int k = 0;
+    for (int i = lo; i < hi; i++) {
+        while (k >= 2 &&
+               orient2d(&sites[hull[k - 2]], &sites[hull[k - 1]],
+                        &sites[i]) <= 0) k--;
+        hull[k++] = i;
+    }
+    return k;
+}
+
+/**
+ * @brief finds the lower common tangent of the sites of two diagrams, the
+ *        bisector of its sites is the bottom edge of the dividing chain, 
+ *        where more sites lie on the tangent the innermost two are taken
+ *
+ * @param left
+ * @param right
+ * @param sites sorted sites
+ * @param lp pointer to which the left site of the tangent is written
+ * @param rp pointer to which the right site of the tangent is written
+ * @return int 0 on success, -1 if allocation failed
+ */
+int lower_tangent(part_t* left, part_t* right, point_t* sites, int* lp,
+                  int* rp) {
+    int *lhull, *rhull;
+    int nl, nr, i, j, moved = 1;
+    if (!(lhull = malloc((right->hi - left->lo) * sizeof(int)))) return -1;
+    rhull = lhull + (left->hi - left->lo);
+    nl = lower_hull(sites, left->lo, left->hi, lhull);
+    nr = lower_hull(sites, right->lo, right->hi, rhull);
+    i = nl - 1;
+    j = 0;
+    while (moved) {
+        moved = 0;
+        while (i > 0 && orient2d(&sites[lhull[i]], &sites[rhull[j]],
+                                 &sites[lhull[i - 1]]) < 0) {
+            i--;
+            moved = 1;
+        }
+        while (j < nr - 1 && orient2d(&sites[lhull[i]], &sites[rhull[j]],
+                                      &sites[rhull[j + 1]]) < 0) {
+            j++;
+            moved = 1;
+        }
+    }
+    *lp = lhull[i];
+    *rp = rhull[j];
+    free(lhull);
+    return 0;
+}
+
+/**
+ * @brief appends a vertex and an edge ending at it to the chain, whose
+ *        arrays are grown together
+ *
+ * @param chain
+ * @param vertex the vertex, NULL for the last edge which goes to infinity
+ * @param l left site of the edge
+ * @param r right site of the edge
+ * @param v index of the new vertex once it is merged
+ * @return int 0 on success, -1 if allocation failed
+ */
+int chain_append(chain_t* chain, point_t* vertex, int l, int r, int v) {
+    point_t* vertices;
+    part_edge_t* edges;
+    part_edge_t* e;
+    if (chain->nedges == chain->size) {
+        int size = chain->size ? 2 * chain->size : 16;
+        if (!(vertices = realloc(chain->vertices, size * sizeof(point_t)))) {
+            return -1;
+        }
+        chain->vertices = vertices;
+        if (!(edges = realloc(chain->edges, size * sizeof(part_edge_t)))) {
+            return -1;
+        }
+        chain->edges = edges;
+        chain->size = size;
+    }
+    e = &chain->edges[chain->nedges];
+    e->site[0] = l;
+    e->site[1] = r;
+    e->v[0] = chain->nedges ? chain->edges[chain->nedges - 1].v[1] : -1;
+    e->v[1] = vertex ? v : -1;
+    chain->nedges++;
+    if (vertex) point_copy(vertex, &chain->vertices[chain->nvertices++]);
+    return 0;
+}
+
+/**
+ * @brief cuts an edge the chain crosses at one of its vertices, keeping 
+ *        the end on the side of the sites of the edge, i.e. away from the
+ *        site of the other diagram the vertex is equidistant to
+ *
+ * @param e copy of the edge
+ * @param sites sorted sites
+ * @param other site of the other diagram
+ * @param v index of the vertex once it is merged
+ */
+void clip_edge(part_edge_t* e, point_t* sites, int other, int v) {
+    if (orient2d(&sites[e->site[0]], &sites[e->site[1]],
+                 &sites[other]) < 0) e->v[0] = v;
+    else e->v[1] = v;
+}
+
+/**
+ * @brief prepares copies of the edges of a diagram for clipping, with 
+ *        their vertices renumbered for the merged diagram
+ *
+ * @param part
+ * @param offset index of the first vertex of the diagram once merged
+ * @param clipped array to which the copies are written
+ */
+void clip_init(part_t* part, int offset, part_edge_t* clipped) {
+    for (int e = 0; e < part->nedges; e++) {
+        clipped[e] = part->edges[e];
+        for (int i = 0; i < 2; i++) {
+            if (clipped[e].v[i] >= 0) clipped[e].v[i] += offset;
+        }
+    }
+}
+
+/**
+ * @brief walks the dividing chain from the bisector of the lower common 
+ *        tangent upwards, at every step the current bisector leaves the 
+ *        cell of its left or its right site, whose neighbour across the 
+ *        crossed edge takes its place, every decision is taken by exact 
+ *        predicates on the sites, so the vertices, computed as the 
+ *        centers of the circles met, only place the edges
+ *
+ * @param left
+ * @param right
+ * @param sites sorted sites
+ * @param chain chain to which the walk is written
+ * @param vertex_offset index of the first chain vertex once merged
+ * @param dropped flags of the edges of both diagrams, left ones first, set
+ *                for every edge that lies on the other side of the chain
+ * @param clipped copies of the edges of both diagrams, cut by the chain
+ * @return int 0 on success, -1 on failure
+ */
+int walk_chain(part_t* left, part_t* right, point_t* sites, chain_t* chain,
+               int vertex_offset, char* dropped, part_edge_t* clipped) {
+    cells_t lcells, rcells;
+    int l, r, hl, hr, lc, rc, steps, status = -1;
+    circle_t circle;
+
+    if (lower_tangent(left, right, sites, &l, &r)) return -1;
+    if (cells_build(&lcells, left)) return -1;
+    if (cells_build(&rcells, right)) {
+        cells_free(&lcells);
+        return -1;
+    }
+
+    /* every step cuts an end of an edge, so a longer walk means the 
+       diagrams are inconsistent */
+    for (steps = 0; steps <= 2 * (left->nedges + right->nedges); steps++) {
+        hl = next_candidate(left, &lcells, sites, l, r, 0, dropped);
+        hr = next_candidate(right, &rcells, sites, l, r, 1,
+                            dropped + left->nedges);
+        if (hl < 0 && hr < 0) {
+            status = chain_append(chain, NULL, l, r, -1);
+            break;
+        }
+        lc = hl < 0 ? -1 : left->edges[hl >> 1].site[!(hl & 1)];
+        rc = hr < 0 ? -1 : right->edges[hr >> 1].site[!(hr & 1)];
+        /* the circle met first holds no site of either diagram, on a tie 
+           the left side moves and the right one follows at the same 
+           vertex on the next step */
+        if (hr < 0 || (hl >= 0 && incircle(&sites[l], &sites[r], &sites[lc],
+                                           &sites[rc]) <= 0)) {
+            if (compute_circumcenter(&sites[l], &sites[r], &sites[lc],
+                                     &circle) ||
+                chain_append(chain, &circle.center, l, r,
+                             vertex_offset + chain->nvertices)) break;
+            clip_edge(&clipped[hl >> 1], sites, r,
+                      vertex_offset + chain->nvertices - 1);
+            l = lc;
+        } else {
+            if (compute_circumcenter(&sites[l], &sites[r], &sites[rc],
+                                     &circle) ||
+                chain_append(chain, &circle.center, l, r,
+                             vertex_offset + chain->nvertices)) break;
+            clip_edge(&clipped[left->nedges + (hr >> 1)], sites, l,
+                      vertex_offset + chain->nvertices - 1);
+            r = rc;
+        }
+    }
+    cells_free(&lcells);
+    cells_free(&rcells);
+    return status;
+}
+
+/**
+ * @brief drops the vertices no edge of a diagram ends at any more, those 
+ *        of the edges discarded by a merge, keeping the others in order
+ *
+ * @param part
+ * @return int 0 on success, -1 if allocation failed
+ */
+int compact_vertices(part_t* part) {
+    int* index;
+    int n = 0;
+    if (!(index = malloc((part->nvertices + 1) * sizeof(int)))) return -1;
+    for (int v = 0; v < part->nvertices; v++) index[v] = -1;
+    for (int e = 0; e < part->nedges; e++) {
+        for (int i = 0; i < 2; i++) {
+            if (part->edges[e].v[i] >= 0) index[part->edges[e].v[i]] = 0;
+        }
+    }
+    /* no vertex moves up, so they are moved in place */
+    for (int v = 0; v < part->nvertices; v++) {
+        if (index[v] < 0) continue;
+        part->vertices[n] = part->vertices[v];
+        index[v] = n++;
+    }
+    for (int e = 0; e < part->nedges; e++) {
+        for (int i = 0; i < 2; i++) {
+            if (part->edges[e].v[i] >= 0) {
+                part->edges[e].v[i] = index[part->edges[e].v[i]];
+            }
+        }
+    }
+    part->nvertices = n;
+    free(index);
+    return 0;
+}
+
+/**
+ * @brief converts the topology of a diagram computed on its own into a
+ *        partial diagram
+ *
+ * @param part partial diagram to be initialized
+ * @param dcel topology of the diagram of the sites [lo, hi)
+ * @param lo first site
+ * @param hi end of the range of sites
+ * @return int 0 on success, -1 if allocation failed
+ */
+int part_from_dcel(part_t* part, voronoi_dcel_t* dcel, int lo, int hi) {
+    int nedges = dcel->nhalfedges / 2;
+    part->lo = lo;
+    part->hi = hi;
+    part->nvertices = dcel->nvertices;
+    part->nedges = nedges;
+    part->vertices = malloc((dcel->nvertices + 1) * sizeof(point_t));
+    part->edges = malloc((nedges + 1) * sizeof(part_edge_t));
+    if (!part->vertices || !part->edges) {
+        part_free(part);
+        return -1;
+    }
+    memcpy(part->vertices, dcel->vertices, dcel->nvertices * sizeof(point_t));
+    for (int e = 0; e < nedges; e++) {
+        for (int i = 0; i < 2; i++) {
+            part->edges[e].v[i] = dcel->halfedges[2 * e + i].origin;
+            part->edges[e].site[i] = dcel->halfedges[2 * e + i].cell + lo;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief merges the diagrams of two neighbouring ranges of sorted, 
+ *        distinct sites, where every site of the left one lies strictly 
+ *        to the left of every site of the right one, the vertices of the 
+ *        dropped edges are dropped from the result
+ *
+ * @param res partial diagram to which the merged diagram is written
+ * @param left
+ * @param right
+ * @param sites sorted sites
+ * @return int 0 on success, -1 on failure
+ */
+int part_merge(part_t* res, part_t* left, part_t* right, point_t* sites) {
+    chain_t chain = {0};
+    int nedges = left->nedges + right->nedges;
+    int offset = left->nvertices + right->nvertices;
+    char* dropped = calloc(nedges + 1, 1);
+    part_edge_t* clipped = malloc((nedges + 1) * sizeof(part_edge_t));
+    int status = -1;
+
+    res->vertices = NULL;
+    res->edges = NULL;
+    if (!dropped || !clipped) goto done;
+    clip_init(left, 0, clipped);
+    clip_init(right, left->nvertices, clipped + left->nedges);
+    if (walk_chain(left, right, sites, &chain, offset, dropped,
+                   clipped)) goto done;
+
+    res->lo = left->lo;
+    res->hi = right->hi;
+    res->nvertices = offset + chain.nvertices;
+    res->vertices = malloc((res->nvertices + 1) * sizeof(point_t));
+    res->edges = malloc((nedges + chain.nedges) * sizeof(part_edge_t));
+    if (!res->vertices || !res->edges) goto done;
+    memcpy(res->vertices, left->vertices, left->nvertices * sizeof(point_t));
+    memcpy(res->vertices + left->nvertices, right->vertices,
+           right->nvertices * sizeof(point_t));
+    memcpy(res->vertices + offset, chain.vertices,
+           chain.nvertices * sizeof(point_t));
+
+    res->nedges = 0;
+    for (int e = 0; e < nedges; e++) {
+        if (!dropped[e]) res->edges[res->nedges++] = clipped[e];
+    }
+    memcpy(res->edges + res->nedges, chain.edges,
+           chain.nedges * sizeof(part_edge_t));
+    res->nedges += chain.nedges;
+    status = compact_vertices(res);
+
+done:
+    if (status) part_free(res);
+    free(dropped);
+    free(clipped);
+    free(chain.vertices);
+    free(chain.edges);
+    return status;
+}
+
+void part_free(part_t* part) {
+    free(part->vertices);
+    free(part->edges);
+    part->vertices = NULL;
+    part->edges = NULL;
+}
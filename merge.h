@@ -0,0 +1,44 @@
+/**
+ * @file merge.h
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief
+ * @version 0.1
+ * @date 2024-03-24
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#ifndef _MERGE_H_
+#define _MERGE_H_
+#include "geometry.h"
+#include "voronoi.h"
+
+/* edge of a partial diagram, seen as the half-edge in the cell of site[0],
+   which runs from v[0] to v[1] with site[0] on its left, -1 for an end at
+   infinity */
+struct part_edge {
+    int v[2];
+    int site[2];
+};
+
+/* voronoi diagram of the sites [lo, hi) of an array sorted by x */
+struct part {
+    int lo;
+    int hi;
+    point_t* vertices;
+    int nvertices;
+    struct part_edge* edges;
+    int nedges;
+};
+
+typedef struct part_edge part_edge_t;
+typedef struct part part_t;
+
+int part_from_dcel(part_t* part, voronoi_dcel_t* dcel, int lo, int hi);
+
+int part_merge(part_t* res, part_t* left, part_t* right, point_t* sites);
+
+void part_free(part_t* part);
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * @file parallel.c
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief runs independent tasks on a group of worker threads, each worker 
+ *        keeps taking the next task that has not been started until none 
+ *        are left
+ * @version 0.1
+ * @date 2024-03-20
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "parallel.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+struct batch {
+    pthread_mutex_t lock;
+    int next;
+    int ntasks;
+    void (*task_fn)(void*, int);
+    void* arg;
+};
+
+typedef struct batch batch_t;
+
+/**
+ * @brief body of a worker, runs tasks until the batch is exhausted
+ * 
+ * @param b batch shared by the workers
+ * @return void* NULL
+ */
+void* worker(void* b) {
+    batch_t* batch = (batch_t*) b;
+    int task;
+    while (1) {
+        pthread_mutex_lock(&batch->lock);
+        task = batch->next < batch->ntasks ? batch->next++ : -1;
+        pthread_mutex_unlock(&batch->lock);
+        if (task < 0) return NULL;
+        batch->task_fn(batch->arg, task);
+    }
+}
+
+/**
+ * @brief returns the number of processors available
+ * 
+ * @return int at least 1
+ */
+int parallel_threads(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int) n : 1;
+}
+
+/**
+ * @brief calls task_fn(arg, i) for every i in [0, ntasks), spread over up to
+ *        nthreads threads including the calling one, and returns once all 
+ *        of them are done
+ * 
+ * @param ntasks number of tasks
+ * @param nthreads maximum number of threads, 0 for one per processor
+ * @param task_fn function running a task
+ * @param arg argument shared by all tasks
+ * @return int number of threads that ran tasks, every task has been run
+ *         even if no worker thread could be started
+ */
+int parallel_for(int ntasks, int nthreads, void (*task_fn)(void*, int),
+                 void* arg) {
+    batch_t batch;
+    pthread_t* threads;
+    int started = 0;
+
+    if (nthreads <= 0) nthreads = parallel_threads();
+    if (nthreads > ntasks) nthreads = ntasks;
+    if (nthreads <= 1 || pthread_mutex_init(&batch.lock, NULL)) {
+        for (int i = 0; i < ntasks; i++) task_fn(arg, i);
+        return 1;
+    }
+    batch.next = 0;
+    batch.ntasks = ntasks;
+    batch.task_fn = task_fn;
+    batch.arg = arg;
+
+    if ((threads = malloc((nthreads - 1) * sizeof(pthread_t)))) {
+        for (; started < nthreads - 1; started++) {
+            if (pthread_create(&threads[started], NULL, worker, &batch)) break;
+        }
+    }
+    worker(&batch);
+    for (int i = 0; i < started; i++) pthread_join(threads[i], NULL);
+    free(threads);
+    pthread_mutex_destroy(&batch.lock);
+    return started + 1;
+}
@@ -0,0 +1,20 @@
+/**
+ * @file parallel.h
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief 
+ * @version 0.1
+ * @date 2024-03-20
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef _PARALLEL_H_
+#define _PARALLEL_H_
+
+int parallel_threads(void);
+
+int parallel_for(int ntasks, int nthreads, void (*task_fn)(void*, int),
+                 void* arg);
+
+#endif
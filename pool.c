@@ -0,0 +1,148 @@
+/**
+ * @file pool.c
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief fixed-size object pool, objects are carved out of large blocks and
+ *        released objects are kept on a free list for reuse
+ * @version 0.1
+ * @date 2024-03-12
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "pool.h"
+#include "stats.h"
+#include <stdlib.h>
+
+/* block headers and object sizes are padded to this so that every object 
+   is suitably aligned for the structs stored in the pool */
+union pool_align {
+    void* ptr;
+    double d;
+    long l;
+};
+
+struct block {
+    struct block* next;
+    union pool_align objects[];
+};
+
+struct pool {
+    size_t obj_size;
+    struct block* first;
+    struct block* current;
+    char* fresh;
+    char* end;
+    void* free_list;
+    /* objects handed out since the last reset, counted with VORONOI_STATS */
+    long allocations;
+};
+
+/**
+ * @brief allocates a new pool handing out objects of a given size
+ * 
+ * @param obj_size size of each object in bytes
+ * @return pool_t* 
+ */
+pool_t* pool_new(size_t obj_size) {
+    pool_t* pool;
+    size_t align = sizeof(union pool_align);
+    if (!(pool = malloc(sizeof(pool_t)))) return NULL;
+    pool->obj_size = (obj_size + align - 1) / align * align;
+    pool->first = NULL;
+    pool->current = NULL;
+    pool->fresh = NULL;
+    pool->end = NULL;
+    pool->free_list = NULL;
+    pool->allocations = 0;
+    return pool;
+}
+
+/**
+ * @brief moves on to the next block, reusing blocks kept from before a 
+ *        reset and allocating a new one otherwise
+ * 
+ * @param pool 
+ * @return int 0 if successful, -1 otherwise
+ */
+int pool_next_block(pool_t* pool) {
+    struct block* block = pool->current ? pool->current->next : pool->first;
+    if (block == NULL) {
+        if (!(block = malloc(sizeof(struct block) +
+                             POOL_BLOCK_OBJECTS * pool->obj_size))) return -1;
+        block->next = NULL;
+        if (pool->current) {
+            pool->current->next = block;
+        } else {
+            pool->first = block;
+        }
+    }
+    pool->current = block;
+    pool->fresh = (char*) block->objects;
+    pool->end = pool->fresh + POOL_BLOCK_OBJECTS * pool->obj_size;
+    return 0;
+}
+
+/**
+ * @brief hands out an object, released objects are reused first
+ * 
+ * @param pool 
+ * @return void* uninitialized object, NULL if allocation fails
+ */
+void* pool_alloc(pool_t* pool) {
+    void* obj;
+    STAT(pool->allocations++);
+    if ((obj = pool->free_list) != NULL) {
+        pool->free_list = *(void**) obj;
+        return obj;
+    }
+    if (pool->fresh == pool->end && pool_next_block(pool)) return NULL;
+    obj = pool->fresh;
+    pool->fresh += pool->obj_size;
+    return obj;
+}
+
+/**
+ * @brief returns an object to the pool
+ * 
+ * @param pool pool the object was allocated from
+ * @param obj 
+ */
+void pool_release(pool_t* pool, void* obj) {
+    *(void**) obj = pool->free_list;
+    pool->free_list = obj;
+}
+
+/**
+ * @brief releases every object at once, the blocks are kept so that 
+ *        refilling the pool does not allocate
+ * 
+ * @param pool 
+ */
+void pool_reset(pool_t* pool) {
+    pool->current = NULL;
+    pool->fresh = NULL;
+    pool->end = NULL;
+    pool->free_list = NULL;
+    pool->allocations = 0;
+}
+
+void pool_free(pool_t* pool) {
+    struct block *block, *next;
+    for (block = pool->first; block != NULL; block = next) {
+        next = block->next;
+        free(block);
+    }
+    free(pool);
+}
+
+/**
+ * @brief counts the objects handed out since the pool was created or last 
+ *        reset, released objects being handed out again count again
+ * 
+ * @param pool 
+ * @return long number of allocations, always 0 without VORONOI_STATS
+ */
+long pool_allocations(pool_t* pool) {
+    return pool->allocations;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file pool.h
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief 
+ * @version 0.1
+ * @date 2024-03-12
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef _POOL_H_
+#define _POOL_H_
+#include <stddef.h>
+
+#define POOL_BLOCK_OBJECTS 1024
+
+struct pool;
+
+typedef struct pool pool_t;
+
+pool_t* pool_new(size_t obj_size);
+
+void* pool_alloc(pool_t* pool);
+
+void pool_release(pool_t* pool, void* obj);
+
+void pool_reset(pool_t* pool);
+
+void pool_free(pool_t* pool);
+
+long pool_allocations(pool_t* pool);
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * @file pqueue_bench.c
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief micro-benchmark of the priority queue operations, prints one 
+ *        comma separated line per queue size
+ * @version 0.1
+ * @date 2024-03-10
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "priority_queue.h"
+
+struct item {
+    double key;
+    int slot;
+};
+
+typedef struct item item_t;
+
+int item_compare(void* i1, void* i2) {
+    return ((item_t*) i1)->key > ((item_t*) i2)->key ? 1 : -1;
+}
+
+int* item_slot(void* i) {
+    return &((item_t*) i)->slot;
+}
+
+double elapsed_ns(clock_t start, int ops) {
+    return (double) (clock() - start) * 1e9 / CLOCKS_PER_SEC / ops;
+}
+
+/**
+ * @brief times n inserts, n/2 removals of arbitrary items and the pops 
+ *        draining the rest of an indexed queue
+ * 
+ * @param n number of items
+ * @return int 0 if successful, -1 otherwise
+ */
+int bench_size(int n) {
+    item_t *items, *item;
+    pqueue_t* que;
+    clock_t start;
+    double insert_ns, remove_ns, pop_ns;
+
+    if (!(items = malloc(n * sizeof(item_t)))) return -1;
+    if (!(que = pqueue_new_indexed(*item_compare, *item_slot))) return -1;
+    for (int i = 0; i < n; i++) items[i].key = (double) rand() / RAND_MAX;
+
+    start = clock();
+    for (int i = 0; i < n; i++) pqueue_insert(que, &items[i]);
+    insert_ns = elapsed_ns(start, n);
+
+    start = clock();
+    for (int i = 0; i < n; i += 2) pqueue_remove(que, &items[i]);
+    remove_ns = elapsed_ns(start, (n + 1) / 2);
+
+    start = clock();
+    while (!pqueue_pop(que, (void**) &item));
+    pop_ns = elapsed_ns(start, n / 2 ? n / 2 : 1);
+
+    printf("%d,%.1f,%.1f,%.1f\n", n, insert_ns, remove_ns, pop_ns);
+    pqueue_free(que);
+    free(items);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int max_size = argc > 1 ? atoi(argv[1]) : 1000000;
+    srand(0);
+    printf("size,insert_ns,remove_ns,pop_ns\n");
+    for (int n = 1000; n <= max_size; n *= 10) {
+        if (bench_size(n)) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,334 @@
+/**
+ * @file predicates.c
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief adaptive precision geometric predicates, each is first evaluated in
+ *        plain floating point along with a bound on its rounding error, and
+ *        only recomputed exactly when the result is too small to trust its
+ *        sign, the exact stage sums products as expansions of
+ *        non-overlapping doubles (Shewchuk, "Adaptive Precision
+ *        Floating-Point Arithmetic and Fast Robust Geometric Predicates")
+ * @version 0.1
+ * @date 2024-04-15
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#include "predicates.h"
+#include <math.h>
+
+/* half an ulp of 1, the relative error of a rounded operation */
+#define ROUNDOFF (1.0 / 9007199254740992.0)
+
+/* error bounds of the floating point stages relative to the magnitude of
+   the terms they sum */
+#define ORIENT_BOUND ((3.0 + 16.0 * ROUNDOFF) * ROUNDOFF)
+#define TANGENT_BOUND ((8.0 + 64.0 * ROUNDOFF) * ROUNDOFF)
+#define INCIRCLE_BOUND ((10.0 + 96.0 * ROUNDOFF) * ROUNDOFF)
+
+/**
+ * @brief computes a + b and the rounding error of the sum, exactly
+ */
+void two_sum(double a, double b, double* sum, double* err) {
+    double bv, av;
+    *sum = a + b;
+    bv = *sum - a;
+    av = *sum - bv;
+    *err = (a - av) + (b - bv);
+}
+
+/**
+ * @brief computes a * b and the rounding error of the product, exactly
+ */
+void two_product(double a, double b, double* product, double* err) {
+    *product = a * b;
+    *err = fma(a, b, -*product);
+}
+
+/**
+ * @brief writes the exact difference a - b as an expansion
+ * 
+ * @return int length of the expansion
+ */
+int difference_expansion(double a, double b, double* h) {
+    double diff, bv, av;
+    diff = a - b;
+    bv = a - diff;
+    av = diff + bv;
+    h[0] = (a - av) + (bv - b);
+    h[1] = diff;
+    if (h[0] != 0) return 2;
+    h[0] = diff;
+    return 1;
+}
+
+/**
+ * @brief adds a double to an expansion, the components of every expansion
+ *        are non-overlapping, ordered by increasing magnitude and nonzero
+ *        unless the expansion is zero
+ * 
+ * @param elen length of e
+ * @param e
+ * @param b
+ * @param h sum, of at most elen + 1 components, may be e itself
+ * @return int length of h
+ */
+int grow_expansion(int elen, double* e, double b, double* h) {
+    double q = b, err;
+    int hlen = 0;
+
+    for (int i = 0; i < elen; i++) {
+        two_sum(q, e[i], &q, &err);
+        if (err != 0) h[hlen++] = err;
+    }
+    if (q != 0 || hlen == 0) h[hlen++] = q;
+    return hlen;
+}
+
+/**
+ * @brief multiplies an expansion by a double
+ * 
+ * @param elen length of e
+ * @param e
+ * @param b
+ * @param h product, of at most 2 * elen components
+ * @return int length of h
+ */
+int scale_expansion(int elen, double* e, double b, double* h) {
+    double q, sum, err, product, product_err;
+    int hlen = 0;
+
+    two_product(e[0], b, &q, &err);
+    if (err != 0) h[hlen++] = err;
+    for (int i = 1; i < elen; i++) {
+        two_product(e[i], b, &product, &product_err);
+        two_sum(q, product_err, &sum, &err);
+        if (err != 0) h[hlen++] = err;
+        two_sum(product, sum, &q, &err);
+        if (err != 0) h[hlen++] = err;
+    }
+    if (q != 0 || hlen == 0) h[hlen++] = q;
+    return hlen;
+}
+
+/**
+ * @brief adds two expansions
+ * 
+ * @param h sum, of at most elen + flen components, must not overlap f
+ * @return int length of h
+ */
+int expansion_sum(int elen, double* e, int flen, double* f, double* h) {
+    int hlen = elen;
+
+    for (int i = 0; i < elen; i++) h[i] = e[i];
+    for (int i = 0; i < flen; i++) hlen = grow_expansion(hlen, h, f[i], h);
+    return hlen;
+}
+
+/**
+ * @brief multiplies two expansions
+ * 
+ * @param h product, of at most 2 * elen * flen components, must not
+ *          overlap either factor
+ * @return int length of h
+ */
+int expansion_product(int elen, double* e, int flen, double* f, double* h) {
+    double scaled[EXPANSION_MAX];
+    int hlen, slen;
+
+    hlen = scale_expansion(elen, e, f[0], h);
+    for (int i = 1; i < flen; i++) {
+        slen = scale_expansion(elen, e, f[i], scaled);
+        hlen = expansion_sum(hlen, h, slen, scaled, h);
+    }
+    return hlen;
+}
+
+/**
+ * @brief computes |a - s|^2 exactly
+ * 
+ * @return int length of the expansion written to h
+ */
+int squared_distance_expansion(point_t* a, point_t* s, double* h) {
+    double dx[2], dy[2], sx[8], sy[8];
+    int dxlen, dylen, sxlen, sylen;
+
+    dxlen = difference_expansion(a->x, s->x, dx);
+    dylen = difference_expansion(a->y, s->y, dy);
+    sxlen = expansion_product(dxlen, dx, dxlen, dx, sx);
+    sylen = expansion_product(dylen, dy, dylen, dy, sy);
+    return expansion_sum(sxlen, sx, sylen, sy, h);
+}
+
+/**
+ * @brief computes (a - c) x (b - c) exactly
+ * 
+ * @return int length of the expansion written to h, at most 16
+ */
+int cross_expansion(point_t* a, point_t* b, point_t* c, double* h) {
+    double acx[2], acy[2], bcx[2], bcy[2], left[8], right[8];
+    int acxlen, acylen, bcxlen, bcylen, llen, rlen;
+
+    acxlen = difference_expansion(a->x, c->x, acx);
+    acylen = difference_expansion(a->y, c->y, acy);
+    bcxlen = difference_expansion(b->x, c->x, bcx);
+    bcylen = difference_expansion(b->y, c->y, bcy);
+    llen = expansion_product(acxlen, acx, bcylen, bcy, left);
+    rlen = expansion_product(acylen, acy, bcxlen, bcx, right);
+    for (int i = 0; i < rlen; i++) right[i] = -right[i];
+    return expansion_sum(llen, left, rlen, right, h);
+}
+
+double orient2d_exact(point_t* a, point_t* b, point_t* c) {
+    double det[16];
+    int dlen = cross_expansion(a, b, c, det);
+    return det[dlen - 1];
+}
+
+/**
+ * @brief tests the orientation of three points
+ * 
+ * @param a
+ * @param b
+ * @param c
+ * @return double positive if a, b and c are in counterclockwise order,
+ *         negative if clockwise and 0 if collinear, only the sign is exact
+ */
+double orient2d(point_t* a, point_t* b, point_t* c) {
+    double left, right, det, detsum;
+
+    left = (a->x - c->x) * (b->y - c->y);
+    right = (a->y - c->y) * (b->x - c->x);
+    det = left - right;
+    if (left > 0) {
+        if (right <= 0) return det;
+        detsum = left + right;
+    } else if (left < 0) {
+        if (right >= 0) return det;
+        detsum = -left - right;
+    } else {
+        return det;
+    }
+    if (fabs(det) >= ORIENT_BOUND * detsum) return det;
+    return orient2d_exact(a, b, c);
+}
+
+double incircle_tangent_exact(point_t* a, point_t* b, point_t* s) {
+    double alift[16], blift[16], ah[2], bh[2], left[64], right[64];
+    double det[128];
+    int alen, blen, ahlen, bhlen, llen, rlen, dlen;
+
+    alen = squared_distance_expansion(a, s, alift);
+    blen = squared_distance_expansion(b, s, blift);
+    ahlen = difference_expansion(a->y, s->y, ah);
+    bhlen = difference_expansion(b->y, s->y, bh);
+    llen = expansion_product(alen, alift, bhlen, bh, left);
+    rlen = expansion_product(blen, blift, ahlen, ah, right);
+    for (int i = 0; i < rlen; i++) right[i] = -right[i];
+    dlen = expansion_sum(llen, left, rlen, right, det);
+    return det[dlen - 1];
+}
+
+/**
+ * @brief in-circle test against the circle through a that is tangent to the
+ *        horizontal line through s, which lies below it, this is the circle
+ *        whose center is the point of a's parabola above s for a sweepline
+ *        at s, so comparing parabolas at a site comes down to this test
+ * 
+ * @param a point of the circle, above s
+ * @param b point tested, not below s
+ * @param s point of tangency
+ * @return double positive if b lies inside the circle, negative if
+ *         outside and 0 if on it, only the sign is exact, this is the sign
+ *         of |a - s|^2 (b.y - s.y) - |b - s|^2 (a.y - s.y)
+ */
+double incircle_tangent(point_t* a, point_t* b, point_t* s) {
+    double ax, ay, bx, by, alift, blift, det, permanent;
+
+    ax = a->x - s->x;
+    ay = a->y - s->y;
+    bx = b->x - s->x;
+    by = b->y - s->y;
+    alift = ax * ax + ay * ay;
+    blift = bx * bx + by * by;
+    det = alift * by - blift * ay;
+    permanent = alift * fabs(by) + blift * fabs(ay);
+    if (fabs(det) > TANGENT_BOUND * permanent) return det;
+    return incircle_tangent_exact(a, b, s);
+}
+
+double incircle_exact(point_t* a, point_t* b, point_t* c, point_t* d) {
+    double alift[16], blift[16], clift[16], bc[16], ca[16], ab[16];
+    double aterm[512], bterm[512], cterm[512], sum[1024], det[1536];
+    int alen, blen, clen, bclen, calen, ablen, atlen, btlen, ctlen, slen;
+    int dlen;
+
+    alen = squared_distance_expansion(a, d, alift);
+    blen = squared_distance_expansion(b, d, blift);
+    clen = squared_distance_expansion(c, d, clift);
+    bclen = cross_expansion(b, c, d, bc);
+    calen = cross_expansion(c, a, d, ca);
+    ablen = cross_expansion(a, b, d, ab);
+    atlen = expansion_product(alen, alift, bclen, bc, aterm);
+    btlen = expansion_product(blen, blift, calen, ca, bterm);
+    ctlen = expansion_product(clen, clift, ablen, ab, cterm);
+    slen = expansion_sum(atlen, aterm, btlen, bterm, sum);
+    dlen = expansion_sum(slen, sum, ctlen, cterm, det);
+    return det[dlen - 1];
+}
+
+/**
+ * @brief in-circle test of a point against the circle through three others
+ * 
+ * @param a
+ * @param b
+ * @param c
+ * @param d point tested
+ * @return double positive if d lies inside the circle through a, b and c,
+ *         which must come in counterclockwise order, negative if outside
+ *         and 0 if on it, only the sign is exact
+ */
+double incircle(point_t* a, point_t* b, point_t* c, point_t* d) {
+    double adx, ady, bdx, bdy, cdx, cdy, alift, blift, clift;
+    double bdxcdy, cdxbdy, cdxady, adxcdy, adxbdy, bdxady, det, permanent;
+
+    adx = a->x - d->x;
+    ady = a->y - d->y;
+    bdx = b->x - d->x;
+    bdy = b->y - d->y;
+    cdx = c->x - d->x;
+    cdy = c->y - d->y;
+    alift = adx * adx + ady * ady;
+    blift = bdx * bdx + bdy * bdy;
+    clift = cdx * cdx + cdy * cdy;
+    bdxcdy = bdx * cdy;
+    cdxbdy = cdx * bdy;
+    cdxady = cdx * ady;
+    adxcdy = adx * cdy;
+    adxbdy = adx * bdy;
+    bdxady = bdx * ady;
+    det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) +
+          clift * (adxbdy - bdxady);
+    permanent = alift * (fabs(bdxcdy) + fabs(cdxbdy)) +
+                blift * (fabs(cdxady) + fabs(adxcdy)) +
+                clift * (fabs(adxbdy) + fabs(bdxady));
+    if (fabs(det) > INCIRCLE_BOUND * permanent) return det;
+    return incircle_exact(a, b, c, d);
+}
+
+/**
+ * @brief compares a value with the midpoint of two others, exactly
+ * 
+ * @param x
+ * @param a
+ * @param b
+ * @return int -1 if x < (a + b) / 2, 0 if equal, 1 if greater
+ */
+int midpoint_compare(double x, double a, double b) {
+    double sum[3];
+    int len;
+
+    sum[0] = 2 * x;
+    len = grow_expansion(1, sum, -a, sum);
+    len = grow_expansion(len, sum, -b, sum);
+    return (sum[len - 1] > 0) - (sum[len - 1] < 0);
+}
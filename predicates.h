@@ -0,0 +1,31 @@
+/**
+ * @file predicates.h
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief exact geometric predicates for the combinatorial decisions of the
+ *        sweep and the merge
+ * @version 0.1
+ * @date 2024-04-15
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef _PREDICATES_H_
+#define _PREDICATES_H_
+#include "geometry.h"
+
+#define SIGN(a) (((a) > 0) - ((a) < 0)) // -1 if a < 0, 0 if a == 0, 1 if a > 0
+
+/* longest partial product of expansion_product, twice the length of its
+   first factor */
+#define EXPANSION_MAX 256
+
+double orient2d(point_t* a, point_t* b, point_t* c);
+
+double incircle(point_t* a, point_t* b, point_t* c, point_t* d);
+
+double incircle_tangent(point_t* a, point_t* b, point_t* s);
+
+int midpoint_compare(double x, double a, double b);
+
+#endif
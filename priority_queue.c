@@ -13,78 +13,114 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
-#include "voronoi.h"
 
 struct pqueue {
     int size;
     int heap_size;
     void** heap;
     int (*compare_fn)(void*, void*);
+    int* (*index_fn)(void*);
 };
 
+/**
+ * @brief recursively checks that no item in the subtree rooted at a given
+ *        slot has a higher priority than its parent, this walks the whole
+ *        heap and is only run in PQUEUE_DEBUG builds
+ * 
+ * @param heap heap array
+ * @param idx slot at which the check starts
+ * @param size number of items in the heap
+ * @param compare_fn function used to compare the priority of two items
+ * @return int 1 if the invariant holds, 0 otherwise
+ */
 int check_heap_invariant(void** heap, int idx, int size, int (*compare_fn)(void*, void*)) {
-    int cidx1, cidx2;;
+    int cidx1, cidx2;
     cidx1 = 2*idx + 1;
     cidx2 = 2*idx + 2;
     if (idx >= size) return 1;
     if (cidx1 < size && compare_fn(heap[idx], heap[cidx1]) == -1) {
-        printf("%d: ", idx);
-        event_print(heap[idx]);
-        printf("%d: ", cidx1);
-        event_print(heap[cidx1]);
+        fprintf(stderr, "heap invariant violated at %d, child %d\n", idx, cidx1);
         return 0;
     }
     if (cidx2 < size && compare_fn(heap[idx], heap[cidx2]) == -1){
-        printf("%d: ", idx);
-        event_print(heap[idx]);
-        printf("%d: ", cidx2);
-        event_print(heap[cidx2]);
+        fprintf(stderr, "heap invariant violated at %d, child %d\n", idx, cidx2);
         return 0;
     } 
     return (check_heap_invariant(heap, cidx1, size, compare_fn) &&
             check_heap_invariant(heap, cidx2, size, compare_fn));
 }
 
-void traverse_up(void** heap, int size, int (*compare_fn)(void*, void*)) {
-    int idx, parent_idx;
-    void* temp;
-    idx = size - 1;
-    parent_idx = (idx - 1) / 2;
+#ifdef PQUEUE_DEBUG
+#define CHECK_HEAP(que) assert(check_heap_invariant((que)->heap, 0, \
+                                (que)->size, (que)->compare_fn))
+#else
+#define CHECK_HEAP(que) ((void) 0)
+#endif
 
-    while (idx > 0 && compare_fn(heap[idx], heap[parent_idx]) == 1) {
+/**
+ * @brief places an item at a given slot of the heap, letting the item know
+ *        of its new slot if the queue is indexed
+ * 
+ * @param que priority queue
+ * @param idx slot in the heap
+ * @param item item to be placed
+ */
+void heap_place(pqueue_t* que, int idx, void* item) {
+    que->heap[idx] = item;
+    if (que->index_fn) *que->index_fn(item) = idx;
+}
 
-        /* swap the elements around */
-        temp = heap[idx];
-        heap[idx] = heap[parent_idx];
-        heap[parent_idx] = temp;
+/**
+ * @brief shifts the item at the given slot up until its parent has a 
+ *        higher priority
+ * 
+ * @param que priority queue
+ * @param idx slot of the item
+ * @return int the final slot of the item
+ */
+int traverse_up(pqueue_t* que, int idx) {
+    int parent_idx;
+    void* item = que->heap[idx];
 
-        /* update the indices */
-        idx = parent_idx;
+    while (idx > 0) {
         parent_idx = (idx - 1) / 2;
+        if (que->compare_fn(item, que->heap[parent_idx]) != 1) break;
+
+        /* the parent moves down into the hole left by the item */
+        heap_place(que, idx, que->heap[parent_idx]);
+        idx = parent_idx;
     }
+    heap_place(que, idx, item);
+    return idx;
 }
 
-void traverse_down(void** heap, int size, int (*compare_fn)(void*, void*)) {
-    int idx, cidx1, cidx2, pidx;
-    void* temp;
-    idx = 0;
-    cidx1 = 1;
-    cidx2 = 2;
-    while (cidx1 < size && (compare_fn(heap[cidx1], heap[idx]) == 1
-           || ( cidx2 < size && compare_fn(heap[cidx2], heap[idx]) == 1))) {
-        temp = heap[cidx1];
+/**
+ * @brief shifts the item at the given slot down until both its children 
+ *        have a lower priority
+ * 
+ * @param que priority queue
+ * @param idx slot of the item
+ * @return int the final slot of the item
+ */
+int traverse_down(pqueue_t* que, int idx) {
+    int cidx1, cidx2, pidx;
+    void* item = que->heap[idx];
+
+    while ((cidx1 = 2*idx + 1) < que->size) {
+        cidx2 = cidx1 + 1;
         pidx = cidx1;
-        if (cidx2 < size && compare_fn(heap[cidx2], heap[cidx1]) == 1) {
-            temp = heap[cidx2];
+        if (cidx2 < que->size &&
+            que->compare_fn(que->heap[cidx2], que->heap[cidx1]) == 1) {
             pidx = cidx2;
         }
-        heap[pidx] = heap[idx];
-        heap[idx] = temp;
+        if (que->compare_fn(que->heap[pidx], item) != 1) break;
 
+        /* the higher priority child moves up into the hole */
+        heap_place(que, idx, que->heap[pidx]);
         idx = pidx;
-        cidx1 = 2*idx + 1;
-        cidx2 = 2*idx + 2;
     }
+    heap_place(que, idx, item);
+    return idx;
 }
 
 /**
@@ -94,6 +130,21 @@ void traverse_down(void** heap, int size, int (*compare_fn)(void*, void*)) {
  * @return pqueue_t* pointer to the pqueue
  */
 pqueue_t *pqueue_new(int (*compare_fn)(void*, void*)) {
+    return pqueue_new_indexed(compare_fn, NULL);
+}
+
+/**
+ * @brief allocate and initialize a priority queue whose items keep track of
+ *        their own slot in the heap, which allows them to be removed or
+ *        have their priority changed in place
+ * 
+ * @param compare_fn function used to compare the priority of two items
+ * @param index_fn function returning the address at which an item stores
+ *                 its slot, may be NULL for a plain queue
+ * @return pqueue_t* pointer to the pqueue
+ */
+pqueue_t *pqueue_new_indexed(int (*compare_fn)(void*, void*),
+                             int* (*index_fn)(void*)) {
     pqueue_t *que;
     if (compare_fn == NULL) return NULL;
     if (!(que = malloc(sizeof(pqueue_t)))) return NULL;
@@ -104,6 +155,7 @@ pqueue_t *pqueue_new(int (*compare_fn)(void*, void*)) {
     que->size = 0;
     que->heap_size = 1;
     que->compare_fn = compare_fn;
+    que->index_fn = index_fn;
     return que;
 }
 
@@ -146,13 +198,9 @@ int pqueue_insert(pqueue_t *que, void* item) {
         que->heap_size *= 2;
 
     }
-    assert(check_heap_invariant(que->heap, 0, que->size, que->compare_fn));
     que->heap[que->size++] = item;
-    traverse_up(que->heap, que->size, que->compare_fn);
-    if (!check_heap_invariant(que->heap, 0, que->size, que->compare_fn)) {
-        pqueue_print(que, *event_print);
-    }
-    assert(check_heap_invariant(que->heap, 0, que->size, que->compare_fn));
+    traverse_up(que, que->size - 1);
+    CHECK_HEAP(que);
     return 0;
 }
 
@@ -184,14 +232,74 @@ int pqueue_pop(pqueue_t *que, void** itemp) {
         return -1;
     }
     *itemp = que->heap[0];
-    assert(check_heap_invariant(que->heap, 0, que->size, que->compare_fn));
-    que->heap[0] = que->heap[que->size-1];
-    traverse_down(que->heap, que->size - 1, que->compare_fn);
-    que->size--;
-    assert(check_heap_invariant(que->heap, 0, que->size, que->compare_fn));
+    if (que->index_fn) *que->index_fn(*itemp) = -1;
+    if (--que->size > 0) {
+        que->heap[0] = que->heap[que->size];
+        traverse_down(que, 0);
+    }
+    CHECK_HEAP(que);
+    return 0;
+}
+
+/**
+ * @brief remove an arbitrary item from an indexed pqueue
+ * 
+ * @param que indexed priority queue
+ * @param item item to be removed
+ * @return int 0 if successful, -1 if the queue is not indexed or the item
+ *         is not in the queue
+ */
+int pqueue_remove(pqueue_t *que, void* item) {
+    int idx;
+    assert(que != NULL && item != NULL);
+    if (que->index_fn == NULL) return -1;
+    idx = *que->index_fn(item);
+    if (idx < 0 || idx >= que->size || que->heap[idx] != item) return -1;
+
+    *que->index_fn(item) = -1;
+    if (idx != --que->size) {
+        /* the last item fills the hole, and may need to move either way */
+        que->heap[idx] = que->heap[que->size];
+        if (traverse_up(que, idx) == idx) traverse_down(que, idx);
+    }
+    CHECK_HEAP(que);
     return 0;
 }
 
+/**
+ * @brief restore the position of an item in an indexed pqueue after its 
+ *        priority has changed
+ * 
+ * @param que indexed priority queue
+ * @param item item whose priority changed
+ * @return int 0 if successful, -1 if the queue is not indexed or the item
+ *         is not in the queue
+ */
+int pqueue_update(pqueue_t *que, void* item) {
+    int idx;
+    assert(que != NULL && item != NULL);
+    if (que->index_fn == NULL) return -1;
+    idx = *que->index_fn(item);
+    if (idx < 0 || idx >= que->size || que->heap[idx] != item) return -1;
+
+    if (traverse_up(que, idx) == idx) traverse_down(que, idx);
+    CHECK_HEAP(que);
+    return 0;
+}
+
+/**
+ * @brief empty the pqueue, keeping its heap capacity for reuse
+ * 
+ * @param que priority queue
+ */
+void pqueue_clear(pqueue_t *que) {
+    assert(que != NULL);
+    if (que->index_fn) {
+        for (int i = 0; i < que->size; i++) *que->index_fn(que->heap[i]) = -1;
+    }
+    que->size = 0;
+}
+
 void pqueue_free(pqueue_t *que) {
     assert(que != NULL && que->size == 0);
     free(que->heap);
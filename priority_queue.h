@@ -19,6 +19,9 @@ typedef struct pqueue pqueue_t;
 
 pqueue_t *pqueue_new(int (*compare_fn)(void*, void*));
 
+pqueue_t *pqueue_new_indexed(int (*compare_fn)(void*, void*),
+                             int* (*index_fn)(void*));
+
 int pqueue_size(pqueue_t* que);
 
 int pqueue_insert(pqueue_t *que, void* item);
@@ -27,8 +30,14 @@ int pqueue_peek(pqueue_t *que, void** itemp);
 
 int pqueue_pop(pqueue_t *que, void** itemp);
 
+int pqueue_remove(pqueue_t *que, void* item);
+
+int pqueue_update(pqueue_t *que, void* item);
+
 void pqueue_print(pqueue_t* que, void (* print_fn)(void*));
 
+void pqueue_clear(pqueue_t *que);
+
 void pqueue_free(pqueue_t *que);
 
 #endif
\ No newline at end of file
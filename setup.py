@@ -1,9 +1,13 @@
 #!/usr/bin/env python3
 
+import os
 from setuptools import setup, Extension
 
+# make python STATS=1 builds the module with voronoi.stats() counting
+macros = [("VORONOI_STATS", None)] if os.environ.get("VORONOI_STATS") else []
+
 setup(
 	name = "voronoi",
 	version = "1.0",
-	ext_modules = [Extension("voronoi", ["uarray.c", "bst.c", "geometry.c", "priority_queue.c", "voronoi.c", "voronoipy.c"])]
+	ext_modules = [Extension("voronoi", ["uarray.c", "pool.c", "beachline.c", "geometry.c", "predicates.c", "priority_queue.c", "parallel.c", "merge.c", "voronoi.c", "voronoipy.c"], define_macros = macros)]
 	)
\ No newline at end of file
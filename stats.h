@@ -0,0 +1,23 @@
+/**
+ * @file stats.h
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief 
+ * @version 0.1
+ * @date 2024-04-12
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef _STATS_H_
+#define _STATS_H_
+
+/* STAT(stmt) only runs stmt in builds with VORONOI_STATS (make STATS=1), 
+   the counters it updates cost nothing otherwise */
+#ifdef VORONOI_STATS
+#define STAT(stmt) stmt
+#else
+#define STAT(stmt)
+#endif
+
+#endif
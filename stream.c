@@ -0,0 +1,196 @@
+/**
+ * @file stream.c
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief 
+ * @version 0.1
+ * @date 2024-03-30
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#include "stream.h"
+#include "priority_queue.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* a sorted run, either spilled to a file or the last one, which stays in 
+   the buffer */
+struct run {
+    FILE* file;
+    /* next site of the run */
+    point_t head;
+    /* position of the site after the head in the buffer */
+    int next;
+};
+
+struct site_runs {
+    point_t* buffer;
+    int nbuffer;
+    int run_sites;
+    struct run* runs;
+    int nruns;
+    int runs_size;
+    /* runs ordered by their heads, only built once all sites are added */
+    pqueue_t* heads;
+};
+
+typedef struct run run_t;
+
+/**
+ * @brief qsort comparator ordering points the way the sweep reaches them
+ * 
+ * @param p1 
+ * @param p2 
+ * @return int negative if p1 comes first, positive if p2 does
+ */
+int point_sweep_compare(const void* p1, const void* p2) {
+    const point_t* a = (const point_t*) p1;
+    const point_t* b = (const point_t*) p2;
+    if (a->y != b->y) return a->y > b->y ? -1 : 1;
+    if (a->x != b->x) return a->x > b->x ? -1 : 1;
+    return 0;
+}
+
+int run_compare(void* r1, void* r2) {
+    return point_sweep_compare(&((run_t*) r1)->head, &((run_t*) r2)->head) 
+           < 0 ? 1 : -1;
+}
+
+/**
+ * @brief allocates an empty set of runs
+ * 
+ * @param run_sites number of sites sorted in memory at once
+ * @return site_runs_t* the runs, NULL if allocation failed
+ */
+site_runs_t* site_runs_new(int run_sites) {
+    site_runs_t* runs;
+    if (run_sites < 1) run_sites = RUN_SITES;
+    if (!(runs = calloc(1, sizeof(site_runs_t)))) return NULL;
+    runs->run_sites = run_sites;
+    if (!(runs->buffer = malloc(run_sites * sizeof(point_t))) ||
+        !(runs->heads = pqueue_new(*run_compare))) {
+        site_runs_free(runs);
+        return NULL;
+    }
+    return runs;
+}
+
+/**
+ * @brief appends a new run, which starts out in the buffer
+ * 
+ * @param runs 
+ * @return run_t* the run, NULL if allocation failed
+ */
+run_t* new_run(site_runs_t* runs) {
+    run_t* temp;
+    if (runs->nruns == runs->runs_size) {
+        int size = runs->runs_size ? 2 * runs->runs_size : 16;
+        if (!(temp = realloc(runs->runs, size * sizeof(run_t)))) return NULL;
+        runs->runs = temp;
+        runs->runs_size = size;
+    }
+    temp = &runs->runs[runs->nruns++];
+    temp->file = NULL;
+    temp->next = 0;
+    return temp;
+}
+
+/**
+ * @brief sorts the buffer and writes it out as a run of its own
+ * 
+ * @param runs 
+ * @return int 0 on success, -1 on failure
+ */
+int spill_run(site_runs_t* runs) {
+    run_t* run;
+    qsort(runs->buffer, runs->nbuffer, sizeof(point_t), point_sweep_compare);
+    if (!(run = new_run(runs)) || !(run->file = tmpfile())) return -1;
+    if (fwrite(runs->buffer, sizeof(point_t), runs->nbuffer, run->file) 
+        < (size_t) runs->nbuffer) return -1;
+    runs->nbuffer = 0;
+    return 0;
+}
+
+/**
+ * @brief adds a site, in any order
+ * 
+ * @param runs 
+ * @param site 
+ * @return int 0 on success, -1 on failure
+ */
+int site_runs_add(site_runs_t* runs, point_t* site) {
+    if (runs->nbuffer == runs->run_sites && spill_run(runs)) return -1;
+    point_copy(site, &runs->buffer[runs->nbuffer++]);
+    return 0;
+}
+
+/**
+ * @brief moves a run on to its next site
+ * 
+ * @param runs 
+ * @param run 
+ * @return int 1 if the run has another site, 0 if it is exhausted, -1 if 
+ *         reading it failed
+ */
+int run_advance(site_runs_t* runs, run_t* run) {
+    if (!run->file) {
+        if (run->next == runs->nbuffer) return 0;
+        point_copy(&runs->buffer[run->next++], &run->head);
+        return 1;
+    }
+    if (fread(&run->head, sizeof(point_t), 1, run->file) == 1) return 1;
+    return ferror(run->file) ? -1 : 0;
+}
+
+/**
+ * @brief sorts the sites that are still buffered and prepares the runs for
+ *        reading, no more sites can be added afterwards
+ * 
+ * @param runs 
+ * @return int 0 on success, -1 on failure
+ */
+int site_runs_finish(site_runs_t* runs) {
+    int status;
+    qsort(runs->buffer, runs->nbuffer, sizeof(point_t), point_sweep_compare);
+    if (runs->nbuffer > 0 && !new_run(runs)) return -1;
+    for (int i = 0; i < runs->nruns; i++) {
+        if (runs->runs[i].file) rewind(runs->runs[i].file);
+        if ((status = run_advance(runs, &runs->runs[i])) < 0) return -1;
+        if (status && pqueue_insert(runs->heads, &runs->runs[i])) return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief reads the next site in sweep order, the runs are passed as a 
+ *        void* so that this can serve as the source of 
+ *        compute_voronoi_stream
+ * 
+ * @param r finished runs
+ * @param site pointer to which the site is written
+ * @return int 1 if a site was read, 0 once all are read, -1 on failure
+ */
+int site_runs_next(void* r, point_t* site) {
+    site_runs_t* runs = (site_runs_t*) r;
+    run_t* run;
+    int status;
+
+    if (pqueue_pop(runs->heads, (void**) &run)) return 0;
+    point_copy(&run->head, site);
+    if ((status = run_advance(runs, run)) < 0) return -1;
+    if (status && pqueue_insert(runs->heads, run)) return -1;
+    return 1;
+}
+
+void site_runs_free(site_runs_t* runs) {
+    for (int i = 0; i < runs->nruns; i++) {
+        if (runs->runs[i].file) fclose(runs->runs[i].file);
+    }
+    if (runs->heads) {
+        pqueue_clear(runs->heads);
+        pqueue_free(runs->heads);
+    }
+    free(runs->runs);
+    free(runs->buffer);
+    free(runs);
+}
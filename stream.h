@@ -0,0 +1,36 @@
+/**
+ * @file stream.h
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief 
+ * @version 0.1
+ * @date 2024-03-30
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef _STREAM_H_
+#define _STREAM_H_
+#include "geometry.h"
+
+/* default number of sites sorted in memory at once */
+#define RUN_SITES (1 << 20)
+
+/* sites sorted in sweep order a bounded number at a time, every full run 
+   is spilled to a temporary file and the runs are merged back as the 
+   sites are read */
+struct site_runs;
+
+typedef struct site_runs site_runs_t;
+
+site_runs_t* site_runs_new(int run_sites);
+
+int site_runs_add(site_runs_t* runs, point_t* site);
+
+int site_runs_finish(site_runs_t* runs);
+
+int site_runs_next(void* runs, point_t* site);
+
+void site_runs_free(site_runs_t* runs);
+
+#endif
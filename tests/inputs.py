@@ -0,0 +1,124 @@
+"""Deterministic inputs of the tests, most of them degenerate on purpose:
+sites sharing an x or a y value, collinear sites and four or more sites on
+a common circle. Every generator but repeated returns a list of distinct
+(x, y) pairs whose coordinates print back as themselves with six
+decimals."""
+
+import math
+import random
+
+
+def uniform(n, seed=1):
+    rng = random.Random(seed)
+    points = {(round(rng.uniform(-20, 20), 6), round(rng.uniform(-20, 20), 6))
+              for _ in range(n)}
+    return sorted(points, key=lambda p: rng.random())
+
+
+def grid(side):
+    """Integer grid, every unit square is cocircular."""
+    rng = random.Random(side)
+    points = [(x, y) for x in range(side) for y in range(side)]
+    rng.shuffle(points)
+    return points
+
+
+def integers(n, span, seed=2):
+    """Random integer points, with many cocircular quadruples."""
+    rng = random.Random(seed)
+    points = set()
+    while len(points) < n:
+        points.add((rng.randint(0, span), rng.randint(0, span)))
+    return sorted(points, key=lambda p: rng.random())
+
+
+def lattice_circle():
+    """All integer points on a circle of radius 65, which has many."""
+    return sorted({(sx * x, sy * y) for x in range(66) for y in range(66)
+                   if x * x + y * y == 65 * 65
+                   for sx in (-1, 1) for sy in (-1, 1)})
+
+
+def big_circle():
+    """All 2916 integer points on the circle of radius 5 * 13 * 17 * 29 * 37
+    * 41, the Gaussian integers of that norm squared."""
+    points = [(1, 0)]
+    for a, b in ((2, 1), (3, 2), (4, 1), (5, 2), (6, 1), (5, 4)):
+        # the prime p = a^2 + b^2 splits into a + bi and a - bi, whose
+        # products of two give the factors of p^2
+        factors = ((a * a - b * b, 2 * a * b), (a * a + b * b, 0),
+                   (a * a - b * b, -2 * a * b))
+        points = [(x * u - y * v, x * v + y * u)
+                  for x, y in points for u, v in factors]
+    return sorted({p for x, y in points
+                   for p in ((x, y), (-y, x), (-x, -y), (y, -x))})
+
+
+def repeated(n, side, seed=5):
+    """Random points of a small integer square, most of them given more
+    than once."""
+    rng = random.Random(seed)
+    return [(rng.randint(0, side), rng.randint(0, side)) for _ in range(n)]
+
+
+def near_circle(n):
+    """Points on a circle rounded to six decimals, so every four of them are
+    nearly but not exactly cocircular."""
+    return [(round(10 * math.cos(2 * math.pi * i / n), 6),
+             round(10 * math.sin(2 * math.pi * i / n), 6)) for i in range(n)]
+
+
+def row(n):
+    return [(float(i), 3.0) for i in range(n)]
+
+
+def column(n):
+    return [(-2.0, float(i)) for i in range(n)]
+
+
+def diagonal(n):
+    return [(float(i), float(2 * i)) for i in range(n)]
+
+
+def columns(ncols, nrows, seed=3):
+    """Sites sharing their x value with the rest of their column."""
+    rng = random.Random(seed)
+    return [(float(c), round(rng.uniform(-5, 5), 6))
+            for c in range(ncols) for _ in range(nrows)]
+
+
+def rows(nrows, ncols, seed=4):
+    """Sites sharing their y value with the rest of their row."""
+    rng = random.Random(seed)
+    return [(round(rng.uniform(-5, 5), 6), float(r))
+            for r in range(nrows) for _ in range(ncols)]
+
+
+def parabola(n):
+    return [(float(x), float(x * x)) for x in range(-n // 2, n - n // 2)]
+
+
+def cross_shape(n):
+    """A row and a column crossing, collinear sites on both axes."""
+    return [(float(i), 0.0) for i in range(-n, n + 1)] + \
+        [(0.0, float(i)) for i in range(-n, n + 1) if i]
+
+
+# inputs small enough for the brute force checks
+DEGENERATE = {
+    "uniform": lambda: uniform(400),
+    "grid": lambda: grid(20),
+    "integers": lambda: integers(400, 40),
+    "lattice_circle": lattice_circle,
+    "near_circle": lambda: near_circle(200),
+    "row": lambda: row(50),
+    "column": lambda: column(50),
+    "diagonal": lambda: diagonal(50),
+    "columns": lambda: columns(20, 20),
+    "rows": lambda: rows(20, 20),
+    "parabola": lambda: parabola(60),
+    "cross": lambda: cross_shape(25),
+    "two": lambda: [(0.0, 0.0), (1.0, 1.0)],
+    "three_collinear": lambda: [(0.0, 0.0), (1.0, 1.0), (2.0, 2.0)],
+    "square": lambda: [(0.0, 0.0), (1.0, 0.0), (0.0, 1.0), (1.0, 1.0)],
+}
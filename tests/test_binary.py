@@ -0,0 +1,59 @@
+"""Round trips of the binary formats of the executable."""
+
+import os
+import subprocess
+import tempfile
+import unittest
+
+import inputs
+import validate
+
+
+class BinaryTest(unittest.TestCase):
+
+    def setUp(self):
+        fd, self.path = tempfile.mkstemp()
+        os.close(fd)
+
+    def tearDown(self):
+        os.remove(self.path)
+
+    def test_round_trip(self):
+        points = inputs.uniform(2000)
+        validate.write_sites_binary(self.path, points)
+        data = validate.run(["-i", "binary", "-o", "binary", self.path])
+        sites, vertices, edges, duals = validate.read_diagram(data)
+        self.assertEqual(len(data), 32 + 16 * (len(sites) + len(vertices)) +
+                         16 * len(edges))
+        self.assertEqual(sites, points)
+        validate.check_diagram(sites, vertices, edges, duals)
+
+        # the text input parses to the same doubles, so the diagram is the
+        # same, and its edges are those of the text output
+        validate.write_sites_text(self.path, points)
+        self.assertEqual(validate.run(["-o", "binary", self.path]), data)
+        pairs = validate.text_pairs(validate.run([self.path]), points)
+        self.assertEqual({frozenset(p) for p in pairs},
+                         {frozenset(p) for p in duals})
+
+    def test_empty(self):
+        for points in ([], [(1.0, 2.0)]):
+            validate.write_sites_binary(self.path, points)
+            data = validate.run(["-i", "binary", "-o", "binary", self.path])
+            self.assertEqual(validate.read_diagram(data),
+                             (points, [], [], []))
+
+    def test_rejected(self):
+        validate.write_sites_binary(self.path, inputs.uniform(10))
+        for args in (["-t", "4", "-o", "binary"], ["-s", "-o", "binary"]):
+            with self.subTest(" ".join(args)):
+                with self.assertRaises(subprocess.CalledProcessError):
+                    validate.run(args + ["-i", "binary", self.path])
+        with open(self.path, "wb") as fd:
+            fd.write(b"VDGM" + bytes(28))
+        with self.assertRaises(subprocess.CalledProcessError):
+            validate.run(["-i", "binary", self.path])
+
+
+if __name__ == "__main__":
+    unittest.main()
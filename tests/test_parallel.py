@@ -0,0 +1,70 @@
+"""Compares the delaunay edges of voronoi -t 4 with those of -t 1."""
+
+import os
+import subprocess
+import tempfile
+import unittest
+
+import inputs
+import validate
+
+
+class ParallelTest(unittest.TestCase):
+
+    def setUp(self):
+        fd, self.path = tempfile.mkstemp(suffix=".txt")
+        os.close(fd)
+
+    def tearDown(self):
+        os.remove(self.path)
+
+    def pairs(self, points, threads):
+        """The delaunay edges as pairs of indices into the sorted distinct
+        points, every edge listed once."""
+        validate.write_sites_text(self.path, points)
+        output = validate.run(["-t", str(threads), self.path])
+        pairs = [frozenset(p) for p in
+                 validate.text_pairs(output, sorted(set(points)))]
+        self.assertEqual(len(set(pairs)), len(pairs))
+        return set(pairs)
+
+    def test_uniform(self):
+        # 4 slabs take at least 4096 points
+        points = inputs.uniform(20000)
+        self.assertEqual(self.pairs(points, 4), self.pairs(points, 1))
+
+    def test_degenerate(self):
+        # the sweep and the merge may split four or more cocircular sites
+        # differently, so the edges may only differ by pairs with a single
+        # empty circle, a point given more than once only counts once
+        for name, points in (("grid", inputs.grid(80)),
+                             ("integers", inputs.integers(8000, 150)),
+                             ("repeated", inputs.repeated(20000, 100)),
+                             ("circle", inputs.big_circle())):
+            with self.subTest(name):
+                sites = sorted(set(points))
+                sequential = self.pairs(points, 1)
+                parallel = self.pairs(points, 4)
+                self.assertEqual(len(sequential),
+                                 validate.expected_edges(sites))
+                self.assertEqual(len(parallel), len(sequential))
+                for pair in sequential ^ parallel:
+                    self.assertEqual(validate.pair_status(sites, *pair), 1,
+                                     "sites %d and %d" % tuple(pair))
+
+    def test_slabs(self):
+        # the inputs above are merged, never swept again on one thread,
+        # which the counters of a make STATS=1 build tell
+        for points, slabs in ((inputs.repeated(20000, 100), 4),
+                              (inputs.big_circle(), 2)):
+            validate.write_sites_text(self.path, points)
+            result = subprocess.run([validate.VORONOI, "-S", "-t", "4",
+                                     self.path], stdout=subprocess.DEVNULL,
+                                    stderr=subprocess.PIPE)
+            if result.returncode:
+                self.skipTest("voronoi was built without make STATS=1")
+            self.assertIn(b"\nslabs %d\n" % slabs, result.stderr)
+
+
+if __name__ == "__main__":
+    unittest.main()
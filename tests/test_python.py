@@ -0,0 +1,204 @@
+"""Tests of the python module, skipped unless it was built with make
+python. The points are passed as memoryviews, which take the same buffer
+path as NumPy arrays without needing NumPy."""
+
+import sys
+import threading
+import unittest
+from array import array
+
+import inputs
+import validate
+
+try:
+    import voronoi
+except ImportError:
+    voronoi = None
+
+
+def as_buffer(points):
+    """A float64 buffer of shape (N, 2) holding the points."""
+    data = array("d", [c for p in points for c in p])
+    return memoryview(data).cast("B").cast("d", (len(points), 2))
+
+
+def as_lists(result):
+    return [[tuple(row) for row in memoryview(a).tolist()] for a in result]
+
+
+@unittest.skipUnless(voronoi, "build the module with make python")
+class ArrayTest(unittest.TestCase):
+
+    def test_arrays(self):
+        for name in ("uniform", "grid", "integers", "lattice_circle",
+                     "columns"):
+            with self.subTest(name):
+                points = inputs.DEGENERATE[name]()
+                sites = [tuple(map(float, p)) for p in points]
+                vertices, edges, duals = \
+                    as_lists(voronoi.voronoi(as_buffer(points)))
+                validate.check_diagram(sites, vertices, edges, duals)
+
+    def test_lists(self):
+        points = inputs.uniform(500)
+        _, _, duals = as_lists(voronoi.voronoi(as_buffer(points)))
+        expected = {frozenset((points[p], points[q])) for p, q in duals}
+        for given in (points, tuple(points), [list(p) for p in points]):
+            with self.subTest(type(given[0]).__name__):
+                (segments, rays), delaunay = voronoi.voronoi(given)
+                self.assertEqual({frozenset(d) for d in delaunay}, expected)
+                self.assertEqual(len(segments) + len(rays), len(delaunay))
+
+    def test_clip(self):
+        points = inputs.uniform(500)
+        box = (-10.0, -15.0, 12.0, 5.0)
+        segments, delaunay = as_lists(voronoi.voronoi(as_buffer(points),
+                                                      clip=box))
+        (expected, rays), duals = voronoi.voronoi(points, clip=box)
+        self.assertEqual(rays, [])
+        self.assertEqual({frozenset((points[p], points[q]))
+                          for p, q in delaunay},
+                         {frozenset(d) for d in duals})
+        # edges missing the rectangle are NaN, the others match the lists
+        inside = [s for s in segments if s[0] == s[0]]
+        self.assertTrue(all(c != c for s in segments if s[0] != s[0]
+                            for c in s))
+        self.assertEqual(sorted(inside),
+                         sorted(a + b for a, b in expected))
+        for x1, y1, x2, y2 in inside:
+            for x, y in ((x1, y1), (x2, y2)):
+                self.assertTrue(box[0] <= x <= box[2] and
+                                box[1] <= y <= box[3])
+
+    def test_cells(self):
+        # the cells must tile the rectangle, counterclockwise, with every
+        # vertex no closer to another point than to that of its cell
+        for name in ("uniform", "grid", "lattice_circle", "near_circle",
+                     "row", "cross", "two"):
+            points = [tuple(map(float, p)) for p in inputs.DEGENERATE[name]()]
+            xs = [p[0] for p in points]
+            ys = [p[1] for p in points]
+            for box in ((min(xs) - 1, min(ys) - 1, max(xs) + 1, max(ys) + 1),
+                        (xs[0] - 2.3, ys[0] - 1.7, xs[0] + 3.1, ys[0] + 2.9)):
+                with self.subTest(name, box=box):
+                    self.check_cells(points, box)
+
+    def check_cells(self, points, box):
+        vertices, bounds = as_lists(voronoi.cells(as_buffer(points), box))
+        area = (box[2] - box[0]) * (box[3] - box[1])
+        tol = 1e-9 * max(box[2] - box[0], box[3] - box[1])
+        total = 0
+        for i, (start, end) in enumerate(bounds):
+            polygon = vertices[start:end]
+            twice = 0
+            for k, (x, y) in enumerate(polygon):
+                self.assertTrue(box[0] <= x <= box[2] and
+                                box[1] <= y <= box[3])
+                own = validate.dist2(points[i], (x, y))
+                self.assertLessEqual(own, validate.nearest(points, (x, y)) +
+                                     tol * (own + 1))
+                u, v = polygon[k - 1], polygon[k - 2]
+                self.assertGreaterEqual(validate.cross(v, u, (x, y)),
+                                        -tol * area)
+                twice += u[0] * y - x * u[1]
+            total += twice / 2
+        self.assertAlmostEqual(total, area, delta=1e-9 * area)
+
+    def test_references(self):
+        points = inputs.uniform(100)
+        result = voronoi.voronoi(points)
+        # held by their container and the argument of getrefcount only
+        self.assertEqual(sys.getrefcount(result), 2)
+        self.assertEqual(sys.getrefcount(result[0]), 2)
+        self.assertEqual(sys.getrefcount(result[1]), 2)
+        self.assertEqual(sys.getrefcount(result[0][0]), 2)
+        self.assertEqual(sys.getrefcount(result[0][1]), 2)
+        self.assertEqual(sys.getrefcount(result[0][0][0]), 2)
+        self.assertEqual(sys.getrefcount(result[0][1][0]), 2)
+        self.assertEqual(sys.getrefcount(result[1][0]), 2)
+
+    def test_invalid(self):
+        data = memoryview(array("d", range(9))).cast("B").cast("d", (3, 3))
+        ints = memoryview(array("i", range(8))).cast("B").cast("i", (4, 2))
+        for points in (data, ints):
+            with self.assertRaises(ValueError):
+                voronoi.voronoi(points)
+        for points in (5, [1.0, 2.0], [(1.0, 2.0, 3.0)], [("a", "b")]):
+            with self.assertRaises(TypeError):
+                voronoi.voronoi(points)
+
+    def test_context(self):
+        context = voronoi.context()
+        points = as_buffer(inputs.uniform(200))
+        result = voronoi.voronoi(points, context)
+        expected = as_lists(result)
+        with self.assertRaises(BufferError):
+            voronoi.voronoi(points, context)
+        del result
+        self.assertEqual(as_lists(voronoi.voronoi(points, context)),
+                         expected)
+
+    def test_reentry(self):
+        # parsing the points runs their __float__, which must not reuse the
+        # context of the call parsing them
+        inner = as_buffer(inputs.uniform(50))
+        kept = []
+
+        class Coordinate:
+            def __float__(self):
+                kept.append(as_lists(call(inner, context)))
+                return 0.0
+
+        for name, call, context in (
+                ("voronoi", voronoi.voronoi, voronoi.context()),
+                ("delaunay", voronoi.delaunay,
+                 voronoi.context(triangles=True)),
+                ("cells", lambda p, c: voronoi.cells(p, (0, 0, 1, 1), c),
+                 voronoi.context())):
+            with self.subTest(name):
+                points = inputs.uniform(20) + [(Coordinate(), 1.0)]
+                with self.assertRaises(RuntimeError):
+                    call(points, context)
+                self.assertEqual(kept, [])
+                # the context is free again afterwards
+                expected = as_lists(call(inner, voronoi.context(
+                    triangles=name == "delaunay")))
+                self.assertEqual(as_lists(call(inner, context)), expected)
+
+
+@unittest.skipUnless(voronoi, "build the module with make python")
+class ThreadTest(unittest.TestCase):
+
+    def test_many(self):
+        tiles = [as_buffer(inputs.uniform(300, seed)) for seed in range(20)]
+        expected = [as_lists(voronoi.voronoi(tile)) for tile in tiles]
+        for threads in (0, 1, 3):
+            with self.subTest(threads=threads):
+                results = voronoi.voronoi_many(tiles, threads=threads)
+                self.assertEqual([as_lists(r) for r in results], expected)
+        # lists take the path of voronoi() as well
+        results = voronoi.voronoi_many([inputs.uniform(50)], threads=2)
+        self.assertEqual(results[0], voronoi.voronoi(inputs.uniform(50)))
+
+    def test_threads(self):
+        # the sweep runs without the GIL, with one context per thread
+        points = as_buffer(inputs.integers(2000, 60))
+        expected = as_lists(voronoi.voronoi(points))
+        results = [None] * 4
+
+        def compute(i):
+            context = voronoi.context()
+            for _ in range(5):
+                results[i] = as_lists(voronoi.voronoi(points, context))
+
+        threads = [threading.Thread(target=compute, args=(i,))
+                   for i in range(len(results))]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        self.assertEqual(results, [expected] * len(results))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,55 @@
+"""Compares the edges streamed by voronoi -s with those of the sweep over
+the whole input, both process the same events in the same order, so the
+edges must be the same even where four or more sites are cocircular."""
+
+import os
+import tempfile
+import unittest
+
+import inputs
+import validate
+
+
+class StreamTest(unittest.TestCase):
+
+    def setUp(self):
+        fd, self.path = tempfile.mkstemp()
+        os.close(fd)
+
+    def tearDown(self):
+        os.remove(self.path)
+
+    def pairs(self, points, args, binary=False):
+        if binary:
+            validate.write_sites_binary(self.path, points)
+            args = ["-i", "binary"] + args
+        else:
+            validate.write_sites_text(self.path, points)
+        output = validate.run(args + [self.path])
+        pairs = validate.text_pairs(output, points)
+        return {frozenset(p) for p in pairs}
+
+    def test_stream(self):
+        for name, make in inputs.DEGENERATE.items():
+            with self.subTest(name):
+                points = make()
+                self.assertEqual(self.pairs(points, ["-s"]),
+                                 self.pairs(points, []))
+
+    def test_runs(self):
+        # runs of 100 points take the external merge of 30 runs
+        points = inputs.integers(3000, 100)
+        expected = self.pairs(points, [])
+        self.assertEqual(self.pairs(points, ["-s", "-m", "100"]), expected)
+        self.assertEqual(self.pairs(points, ["-s", "-m", "100"], True),
+                         expected)
+
+    def test_repeated(self):
+        # the copies of a point end up next to each other in every run
+        points = inputs.repeated(3000, 40)
+        self.assertEqual(self.pairs(points, ["-s", "-m", "100"]),
+                         self.pairs(points, []))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,57 @@
+"""Checks the diagrams of the sequential sweep, python3 -m unittest
+discover -s tests runs every test, make test builds voronoi first."""
+
+import os
+import tempfile
+import unittest
+
+import inputs
+import validate
+
+
+class SweepTest(unittest.TestCase):
+
+    def setUp(self):
+        fd, self.path = tempfile.mkstemp(suffix=".bin")
+        os.close(fd)
+
+    def tearDown(self):
+        os.remove(self.path)
+
+    def diagram(self, points):
+        validate.write_sites_binary(self.path, points)
+        return validate.read_diagram(
+            validate.run(["-i", "binary", "-o", "binary", self.path]))
+
+    def test_degenerate(self):
+        for name, make in inputs.DEGENERATE.items():
+            with self.subTest(name):
+                points = make()
+                sites, vertices, edges, duals = self.diagram(points)
+                self.assertEqual(sites, [tuple(map(float, p))
+                                         for p in points])
+                validate.check_diagram(sites, vertices, edges, duals)
+
+    def test_text_input(self):
+        points = inputs.integers(300, 30)
+        validate.write_sites_text(self.path, points)
+        pairs = validate.text_pairs(validate.run([self.path]), points)
+        self.assertEqual(len(set(map(frozenset, pairs))),
+                         validate.expected_edges(points))
+        for p, q in pairs:
+            self.assertTrue(validate.pair_status(points, p, q))
+
+    def test_repeated(self):
+        # a point given more than once is a site at its first occurrence
+        points = inputs.repeated(600, 20)
+        sites = sorted(set(points))
+        validate.write_sites_text(self.path, points)
+        pairs = validate.text_pairs(validate.run([self.path]), sites)
+        self.assertEqual(len(pairs), validate.expected_edges(sites))
+        for p, q in pairs:
+            self.assertNotEqual(p, q)
+            self.assertTrue(validate.pair_status(sites, p, q))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+"""Checks voronoi diagrams against the empty circle property by brute force.
+
+Every vertex of a diagram must be the center of a circle through the sites
+of the edges meeting there with no site inside, every edge must separate
+two sites that such a circle passes through, and the edges must form a
+complete triangulation, i.e. there are 3n - 3 - h of them for n sites, h of
+which lie on the convex hull, or n - 1 if all sites are collinear.
+
+    python3 tests/validate.py diagram.bin
+
+checks a diagram written by voronoi -o binary. The other functions run the
+executable and read its outputs for the tests.
+"""
+
+import os
+import re
+import struct
+import subprocess
+import sys
+from array import array
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+VORONOI = os.path.join(ROOT, "voronoi")
+
+# relative tolerance of the distances compared, the vertices are rounded
+TOLERANCE = 1e-9
+
+
+def write_sites_text(path, points):
+    with open(path, "w") as fd:
+        fd.write("%d\n" % len(points))
+        fd.write("".join("%.17g %.17g\n" % p for p in points))
+
+
+def write_sites_binary(path, points):
+    with open(path, "wb") as fd:
+        fd.write(b"VSIT" + struct.pack("<IQQQ", 1, len(points), 0, 0))
+        array("d", [c for p in points for c in p]).tofile(fd)
+
+
+def read_diagram(data):
+    """Parses a diagram file, returns (sites, vertices, edges, duals)."""
+    magic, version, nsites, nvertices, nedges = \
+        struct.unpack("<4sIQQQ", data[:32])
+    if magic != b"VDGM" or version != 1:
+        raise ValueError("not a version 1 diagram file")
+    offset = 32
+    coords = array("d")
+    coords.frombytes(data[offset:offset + 16 * (nsites + nvertices)])
+    offset += 16 * (nsites + nvertices)
+    indices = array("i")
+    indices.frombytes(data[offset:offset + 16 * nedges])
+    if sys.byteorder != "little":
+        coords.byteswap()
+        indices.byteswap()
+    points = list(zip(coords[0::2], coords[1::2]))
+    pairs = list(zip(indices[0::2], indices[1::2]))
+    return points[:nsites], points[nsites:], pairs[:nedges], pairs[nedges:]
+
+
+def run(args, stdin=None):
+    """Runs the executable, returns its output, raises if it fails, with
+    the error messages in the stderr of the exception."""
+    return subprocess.run([VORONOI] + args, input=stdin, check=True,
+                          stdout=subprocess.PIPE,
+                          stderr=subprocess.PIPE).stdout
+
+
+def text_pairs(output, sites):
+    """Reads the delaunay edges of the text output as pairs of site
+    indices, the sites must print back as themselves with six decimals,
+    lines, which only arise for collinear sites, are skipped."""
+    index = {("%.6f" % x, "%.6f" % y): i for i, (x, y) in enumerate(sites)}
+    edges = output.decode().split("\n", 1)[1]
+    coords = re.findall(r"\[(-?[0-9.]+), (-?[0-9.]+)\]", edges)
+    ids = [index[c] for c in coords]
+    return list(zip(ids[0::2], ids[1::2]))
+
+
+def dist2(p, q):
+    return (p[0] - q[0]) ** 2 + (p[1] - q[1]) ** 2
+
+
+def cross(o, a, b):
+    return (a[0] - o[0]) * (b[1] - o[1]) - (a[1] - o[1]) * (b[0] - o[0])
+
+
+def hull_count(sites):
+    """Number of sites on the boundary of the convex hull, collinear ones
+    included, all of them if the sites are collinear."""
+    pts = sorted(set(sites))
+    if len(pts) < 3:
+        return len(pts)
+    lower, upper = [], []
+    for p in pts:
+        while len(lower) >= 2 and cross(lower[-2], lower[-1], p) <= 0:
+            lower.pop()
+        lower.append(p)
+    for p in reversed(pts):
+        while len(upper) >= 2 and cross(upper[-2], upper[-1], p) <= 0:
+            upper.pop()
+        upper.append(p)
+    hull = lower[:-1] + upper[:-1]
+    if len(hull) < 3:
+        return len(pts)
+    count = 0
+    for p in pts:
+        for a, b in zip(hull, hull[1:] + hull[:1]):
+            if cross(a, b, p) == 0 and \
+               min(a[0], b[0]) <= p[0] <= max(a[0], b[0]) and \
+               min(a[1], b[1]) <= p[1] <= max(a[1], b[1]):
+                count += 1
+                break
+    return count
+
+
+def expected_edges(sites):
+    h = hull_count(sites)
+    n = len(sites)
+    return n - 1 if h == n and collinear(sites) else 3 * n - 3 - h
+
+
+def collinear(sites):
+    return all(cross(sites[0], sites[1], p) == 0 for p in sites[2:])
+
+
+def nearest(sites, p):
+    return min(dist2(s, p) for s in sites)
+
+
+def check_center(sites, center, corners, scale, what):
+    """Checks that no site lies closer to center than the given ones, all
+    of which must lie at the same distance."""
+    r = [dist2(sites[i], center) for i in corners]
+    tol = TOLERANCE * (max(r) + scale)
+    if max(r) - min(r) > tol:
+        raise AssertionError("%s: sites %s are not equidistant from %r"
+                             % (what, corners, center))
+    if nearest(sites, center) < min(r) - tol:
+        raise AssertionError("%s: a site lies inside the circle of %s "
+                             "around %r" % (what, corners, center))
+
+
+def check_diagram(sites, vertices, edges, duals):
+    """Raises AssertionError unless the diagram is that of the sites."""
+    n = len(sites)
+    if n < 2:
+        assert not edges, "edges without two sites"
+        return
+    xs = [p[0] for p in sites]
+    ys = [p[1] for p in sites]
+    scale = (max(xs) - min(xs)) ** 2 + (max(ys) - min(ys)) ** 2
+    assert len(edges) == len(duals)
+    corners = [set() for _ in vertices]
+    seen = set()
+    for k, ((a, b), (p, q)) in enumerate(zip(edges, duals)):
+        assert 0 <= p < n and 0 <= q < n and p != q, \
+            "edge %d separates sites %d and %d" % (k, p, q)
+        pair = (min(p, q), max(p, q))
+        assert pair not in seen, "sites %d and %d separated twice" % pair
+        seen.add(pair)
+        for v in (a, b):
+            assert -1 <= v < len(vertices), "edge %d ends at %d" % (k, v)
+            if v >= 0:
+                corners[v].update(pair)
+        sp, sq = sites[p], sites[q]
+        # a ray runs from its vertex with the first site on its left, a
+        # line is checked at the midpoint of its sites
+        d = (sp[1] - sq[1], sq[0] - sp[0])
+        if a >= 0 and b < 0:
+            v = vertices[a]
+            check_center(sites, (v[0] + d[0], v[1] + d[1]), (p, q), scale,
+                         "ray %d" % k)
+        elif a < 0 and b >= 0:
+            v = vertices[b]
+            check_center(sites, (v[0] - d[0], v[1] - d[1]), (p, q), scale,
+                         "ray %d" % k)
+        elif a < 0 and b < 0:
+            mid = ((sp[0] + sq[0]) / 2, (sp[1] + sq[1]) / 2)
+            check_center(sites, mid, (p, q), scale, "line %d" % k)
+    for v, sites_at in enumerate(corners):
+        assert len(sites_at) >= 3, "vertex %d has %d sites" % \
+            (v, len(sites_at))
+        check_center(sites, vertices[v], sorted(sites_at), scale,
+                     "vertex %d" % v)
+    expected = expected_edges(sites)
+    assert len(edges) == expected, "%d edges instead of %d" % \
+        (len(edges), expected)
+
+
+def pair_interval(sites, p, q):
+    """Range of the positions along the bisector of two sites of the
+    centers of the circles through both with no site inside, the sites
+    must have integer coordinates so that it is exact, returns (lo, hi)
+    as fractions (num, den) with den > 0."""
+    a, b = sites[p], sites[q]
+    u = (a[1] - b[1], b[0] - a[0])
+    lo, hi = None, None
+    for s in sites:
+        # |c - s|^2 >= |c - a|^2 for c = (a + b) / 2 + t u, i.e.
+        # 2 t u.(s - a) <= |s|^2 - |a|^2 - (a + b).(s - a)
+        w = (s[0] - a[0], s[1] - a[1])
+        num = s[0] ** 2 + s[1] ** 2 - a[0] ** 2 - a[1] ** 2 - \
+            (a[0] + b[0]) * w[0] - (a[1] + b[1]) * w[1]
+        den = 2 * (u[0] * w[0] + u[1] * w[1])
+        if den > 0:
+            if hi is None or num * hi[1] < hi[0] * den:
+                hi = (num, den)
+        elif den < 0:
+            if lo is None or -num * lo[1] > lo[0] * -den:
+                lo = (-num, -den)
+        elif num < 0:
+            return (1, 1), (0, 1)
+    return lo, hi
+
+
+def pair_status(sites, p, q):
+    """0 if no empty circle passes through the two sites, 1 if exactly one
+    does, so the voronoi edge between them has zero length, 2 otherwise."""
+    lo, hi = pair_interval(sites, p, q)
+    if lo is None or hi is None:
+        return 2
+    diff = hi[0] * lo[1] - lo[0] * hi[1]
+    return 0 if diff < 0 else 1 if diff == 0 else 2
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        sys.exit("usage: %s diagram.bin" % sys.argv[0])
+    with open(sys.argv[1], "rb") as fd:
+        check_diagram(*read_diagram(fd.read()))
+    print("ok")
@@ -0,0 +1,444 @@
+/**
+ * @file text.c
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief reads and writes the text format of the voronoi executable 
+ *        without going through scanf and printf, numbers are parsed and 
+ *        formatted by hand into large blocks, independent of the locale
+ * @version 0.1
+ * @date 2024-04-04
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#include "text.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* decimals written by text_write_double, as printf's %f does */
+#define TEXT_DECIMALS 1000000.0
+
+/* largest magnitude formatted by hand, beyond it the scaled value no
+   longer has a fractional part to round */
+#define TEXT_FAST_LIMIT 4.0e9
+
+static const double powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+int is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' ||
+           c == '\f';
+}
+
+int is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief opens a file for reading
+ * 
+ * @param reader reader to be initialized
+ * @param filename 
+ * @return int 0 on success, -1 if the file could not be opened
+ */
+int text_reader_open(text_reader_t* reader, char* filename) {
+    memset(reader, 0, sizeof(text_reader_t));
+    if (!(reader->data = malloc(TEXT_BUFFER + 1))) return -1;
+    if (!(reader->file = fopen(filename, "r"))) {
+        free(reader->data);
+        return -1;
+    }
+    reader->data[0] = '\0';
+    return 0;
+}
+
+void text_reader_close(text_reader_t* reader) {
+    if (reader->file) fclose(reader->file);
+    free(reader->data);
+    memset(reader, 0, sizeof(text_reader_t));
+}
+
+/**
+ * @brief makes sure that the next bytes of the file are in the buffer, 
+ *        the buffer always ends in a null byte so parsing stops there
+ * 
+ * @param reader 
+ * @param need number of bytes needed, fewer are left at the end of file
+ */
+void reader_fill(text_reader_t* reader, size_t need) {
+    size_t left = reader->len - reader->pos;
+    if (left >= need || reader->eof) return;
+    memmove(reader->data, reader->data + reader->pos, left);
+    reader->pos = 0;
+    reader->len = left + fread(reader->data + left, 1, TEXT_BUFFER - left,
+                               reader->file);
+    if (reader->len < TEXT_BUFFER) reader->eof = 1;
+    reader->data[reader->len] = '\0';
+}
+
+/**
+ * @brief skips the whitespace before the next token and brings the token 
+ *        into the buffer
+ * 
+ * @param reader 
+ * @return int 1 if there is a token, 0 at the end of file
+ */
+int reader_token(text_reader_t* reader) {
+    while (1) {
+        while (reader->pos < reader->len && 
+               is_space(reader->data[reader->pos])) reader->pos++;
+        if (reader->pos < reader->len) break;
+        if (reader->eof) return 0;
+        reader_fill(reader, TEXT_BUFFER);
+    }
+    reader_fill(reader, TEXT_TOKEN);
+    return 1;
+}
+
+/**
+ * @brief parses a decimal number, numbers of up to 19 significant digits 
+ *        and small exponents, which covers anything printed with %f, are 
+ *        converted exactly with a single rounding, others go to strtod
+ * 
+ * @param str null-terminated text
+ * @param endp pointer to which the end of the number is written
+ * @param value pointer to which the number is written
+ * @return int 0 on success, -1 if there is no number
+ */
+int parse_double(const char* str, const char** endp, double* value) {
+    const char* p = str;
+    uint64_t mantissa = 0;
+    int negative = 0, digits = 0, exponent = 0, truncated = 0, any = 0;
+    int exp_sign = 1, exp_value = 0;
+    char* end;
+
+    if (*p == '+' || *p == '-') negative = *p++ == '-';
+    for (; is_digit(*p); p++, any = 1) {
+        if (digits < 19) {
+            mantissa = 10 * mantissa + (*p - '0');
+            if (mantissa) digits++;
+        } else {
+            exponent++;
+            truncated |= *p != '0';
+        }
+    }
+    if (*p == '.') {
+        for (p++; is_digit(*p); p++, any = 1) {
+            if (digits < 19) {
+                mantissa = 10 * mantissa + (*p - '0');
+                if (mantissa) digits++;
+                exponent--;
+            } else {
+                truncated |= *p != '0';
+            }
+        }
+    }
+    if (!any) {
+        /* inf, nan and the like */
+        *value = strtod(str, &end);
+        *endp = end;
+        return end == str ? -1 : 0;
+    }
+    if (*p == 'e' || *p == 'E') {
+        const char* q = p + 1;
+        if (*q == '+' || *q == '-') exp_sign = *q++ == '-' ? -1 : 1;
+        if (is_digit(*q)) {
+            for (; is_digit(*q); q++) {
+                if (exp_value < 100000) exp_value = 10 * exp_value + (*q - '0');
+            }
+            exponent += exp_sign * exp_value;
+            p = q;
+        }
+    }
+    if (truncated || mantissa > ((uint64_t) 1 << 53) || exponent < -22 || 
+        exponent > 22) {
+        *value = strtod(str, &end);
+        *endp = end;
+        return 0;
+    }
+    *value = exponent < 0 ? (double) mantissa / powers_of_ten[-exponent]
+                          : (double) mantissa * powers_of_ten[exponent];
+    if (negative) *value = -*value;
+    *endp = p;
+    return 0;
+}
+
+/**
+ * @brief reads the next number as a double
+ * 
+ * @param reader 
+ * @param value pointer to which the number is written
+ * @return int 1 if a number was read, 0 at the end of file, -1 if the next
+ *         token is not a number
+ */
+int text_read_double(text_reader_t* reader, double* value) {
+    const char* end;
+    if (!reader_token(reader)) return 0;
+    if (parse_double(reader->data + reader->pos, &end, value)) return -1;
+    reader->pos = end - reader->data;
+    return 1;
+}
+
+/**
+ * @brief reads the next number as an int
+ * 
+ * @param reader 
+ * @param value pointer to which the number is written
+ * @return int 1 if a number was read, 0 at the end of file, -1 if the next
+ *         token is not an integer
+ */
+int text_read_int(text_reader_t* reader, int* value) {
+    char* p;
+    long result;
+    if (!reader_token(reader)) return 0;
+    p = reader->data + reader->pos;
+    result = strtol(p, &p, 10);
+    if (p == reader->data + reader->pos || result < 0 || result > INT32_MAX) {
+        return -1;
+    }
+    reader->pos = p - reader->data;
+    *value = (int) result;
+    return 1;
+}
+
+/**
+ * @brief starts writing to a file
+ * 
+ * @param writer writer to be initialized
+ * @param file 
+ * @return int 0 on success, -1 if allocation failed
+ */
+int text_writer_init(text_writer_t* writer, FILE* file) {
+    writer->file = file;
+    writer->len = 0;
+    writer->failed = 0;
+    return (writer->data = malloc(TEXT_BUFFER)) ? 0 : -1;
+}
+
+/**
+ * @brief writes out the buffered text
+ * 
+ * @param writer 
+ * @return int 0 if everything written so far reached the file, -1 
+ *         otherwise
+ */
+int text_writer_flush(text_writer_t* writer) {
+    if (writer->len && fwrite(writer->data, 1, writer->len, writer->file) 
+        < writer->len) writer->failed = 1;
+    writer->len = 0;
+    if (fflush(writer->file)) writer->failed = 1;
+    return writer->failed ? -1 : 0;
+}
+
+void text_writer_free(text_writer_t* writer) {
+    free(writer->data);
+    writer->data = NULL;
+}
+
+/**
+ * @brief makes room for a number of bytes in the buffer
+ * 
+ * @param writer 
+ * @param need 
+ */
+void writer_reserve(text_writer_t* writer, size_t need) {
+    if (writer->len + need <= TEXT_BUFFER) return;
+    if (fwrite(writer->data, 1, writer->len, writer->file) < writer->len) {
+        writer->failed = 1;
+    }
+    writer->len = 0;
+}
+
+void text_write(text_writer_t* writer, const char* str) {
+    size_t n = strlen(str);
+    if (n > TEXT_BUFFER) {
+        text_writer_flush(writer);
+        if (fwrite(str, 1, n, writer->file) < n) writer->failed = 1;
+        return;
+    }
+    writer_reserve(writer, n);
+    memcpy(writer->data + writer->len, str, n);
+    writer->len += n;
+}
+
+/**
+ * @brief rounds value * 10^6 to the nearest integer, ties to even, as 
+ *        printf rounds the exact binary value, the error of the product is
+ *        recovered exactly by splitting the value in halves (Dekker)
+ * 
+ * @param value finite value below TEXT_FAST_LIMIT in magnitude
+ * @return int64_t 
+ */
+int64_t scale_round(double value) {
+    double scaled = value * TEXT_DECIMALS, split, high, low, err, rounded;
+    split = 134217729.0 * value;
+    high = split - (split - value);
+    low = value - high;
+    /* 10^6 has 14 significant bits so both partial products are exact */
+    err = (high * TEXT_DECIMALS - scaled) + low * TEXT_DECIMALS;
+    rounded = nearbyint(scaled);
+    /* an apparent tie is broken by the error, nearbyint already made it 
+       even otherwise */
+    if (scaled - rounded == 0.5 && err > 0) rounded += 1;
+    if (scaled - rounded == -0.5 && err < 0) rounded -= 1;
+    return (int64_t) rounded;
+}
+
+/**
+ * @brief writes a double the way printf's %f does
+ * 
+ * @param writer 
+ * @param value 
+ */
+void text_write_double(text_writer_t* writer, double value) {
+    char digits[24];
+    char* out;
+    int64_t scaled;
+    uint64_t whole, frac;
+    int n = 0;
+
+    if (!(fabs(value) < TEXT_FAST_LIMIT)) {
+        /* %f of the largest doubles runs over 300 digits */
+        writer_reserve(writer, 400);
+        writer->len += snprintf(writer->data + writer->len, 400, "%f", value);
+        return;
+    }
+    writer_reserve(writer, 32);
+    out = writer->data + writer->len;
+    scaled = scale_round(value);
+    if (signbit(value)) *out++ = '-';
+    whole = (uint64_t) llabs(scaled) / 1000000;
+    frac = (uint64_t) llabs(scaled) % 1000000;
+    do {
+        digits[n++] = '0' + whole % 10;
+        whole /= 10;
+    } while (whole);
+    while (n) *out++ = digits[--n];
+    *out++ = '.';
+    for (int i = 5; i >= 0; i--, frac /= 10) out[i] = '0' + frac % 10;
+    out += 6;
+    writer->len = out - writer->data;
+}
+
+/**
+ * @brief reads the header of a text input, which is the number of points
+ * 
+ * @param reader reader of the input file
+ * @return int number of points, -1 on failure
+ */
+int text_read_count(text_reader_t* reader) {
+    int args;
+    return text_read_int(reader, &args) == 1 ? args : -1;
+}
+
+/**
+ * @brief reads the next input point
+ * 
+ * @param reader reader of the input file
+ * @param point pointer to which the point is written
+ * @return int 0 on success, -1 on failure
+ */
+int text_read_point(text_reader_t* reader, point_t* point) {
+    if (text_read_double(reader, &point->x) != 1 ||
+        text_read_double(reader, &point->y) != 1) return -1;
+    return 0;
+}
+
+/**
+ * @brief reads the input points into an array
+ * 
+ * @param filename path to the input file
+ * @param pointsp pointer to which the allocated array is written
+ * @return int number of points read, -1 on failure
+ */
+int text_read_points(char* filename, point_t** pointsp) {
+    text_reader_t reader;
+    int args;
+    point_t* points;
+
+    if (text_reader_open(&reader, filename)) return -1;
+    if ((args = text_read_count(&reader)) < 0 ||
+        !(points = malloc((args + 1) * sizeof(point_t)))) {
+        text_reader_close(&reader);
+        return -1;
+    }
+    for (int i = 0; i < args; i++) {
+        if (text_read_point(&reader, &points[i])) {
+            free(points);
+            text_reader_close(&reader);
+            return -1;
+        }
+    }
+    text_reader_close(&reader);
+    *pointsp = points;
+    return args;
+}
+
+void text_write_point(text_writer_t* writer, point_t* point) {
+    text_write(writer, "[");
+    text_write_double(writer, point->x);
+    text_write(writer, ", ");
+    text_write_double(writer, point->y);
+    text_write(writer, "]");
+}
+
+void text_write_points(text_writer_t* writer, point_t* points, int npoints) {
+    for (int i = 0; i < npoints; i++) {
+        text_write_point(writer, &points[i]);
+        text_write(writer, ", ");
+    }
+    text_write(writer, "\n");
+}
+
+/**
+ * @brief writes an edge the way segment_print prints it
+ * 
+ * @param sink writer of the output
+ * @param seg 
+ * @param dp1 input point of the first site of the dual, dual.site1
+ * @param dp2 input point of the second site of the dual, dual.site2
+ * @return int 0, so that this can serve as the sink of 
+ *         compute_voronoi_stream
+ */
+int text_write_segment(void* sink, segment_t* seg, point_t* dp1,
+                       point_t* dp2) {
+    text_writer_t* writer = (text_writer_t*) sink;
+    switch (seg->label) {
+        case SEG_LINE:
+            text_write(writer, "LINE grad ");
+            text_write_double(writer, seg->options.line.gradient);
+            text_write(writer, ", intercept ");
+            text_write_double(writer, seg->options.line.intercept);
+            text_write(writer, "\n");
+            break;
+        case SEG_RAY:
+        case SEG_SEG:
+            text_write(writer, "[");
+            text_write_point(writer, dp1);
+            text_write(writer, ", ");
+            text_write_point(writer, dp2);
+            text_write(writer, "], ");
+            break;
+    }
+    return 0;
+}
+
+/**
+ * @brief writes the edges of a diagram on one line
+ * 
+ * @param writer 
+ * @param edges 
+ * @param nedges number of edges
+ * @param sites input points the duals of the edges index into
+ */
+void text_write_segments(text_writer_t* writer, segment_t* edges, int nedges,
+                         point_t* sites) {
+    for (int i = 0; i < nedges; i++) {
+        text_write_segment(writer, &edges[i], &sites[edges[i].dual.site1],
+                           &sites[edges[i].dual.site2]);
+    }
+    text_write(writer, "\n");
+}
@@ -0,0 +1,77 @@
+/**
+ * @file text.h
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief 
+ * @version 0.1
+ * @date 2024-04-04
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef _TEXT_H_
+#define _TEXT_H_
+#include <stdio.h>
+#include "geometry.h"
+
+/* size of the buffers of readers and writers */
+#define TEXT_BUFFER (1 << 22)
+
+/* longest number a reader parses */
+#define TEXT_TOKEN 512
+
+/* reads numbers from a file a large block at a time */
+struct text_reader {
+    FILE* file;
+    char* data;
+    size_t pos;
+    size_t len;
+    int eof;
+};
+
+/* formats text into a large block which is written out once full */
+struct text_writer {
+    FILE* file;
+    char* data;
+    size_t len;
+    int failed;
+};
+
+typedef struct text_reader text_reader_t;
+typedef struct text_writer text_writer_t;
+
+int text_reader_open(text_reader_t* reader, char* filename);
+
+void text_reader_close(text_reader_t* reader);
+
+int text_read_int(text_reader_t* reader, int* value);
+
+int text_read_double(text_reader_t* reader, double* value);
+
+int text_writer_init(text_writer_t* writer, FILE* file);
+
+int text_writer_flush(text_writer_t* writer);
+
+void text_writer_free(text_writer_t* writer);
+
+void text_write(text_writer_t* writer, const char* str);
+
+void text_write_double(text_writer_t* writer, double value);
+
+int text_read_count(text_reader_t* reader);
+
+int text_read_point(text_reader_t* reader, point_t* point);
+
+int text_read_points(char* filename, point_t** pointsp);
+
+void text_write_point(text_writer_t* writer, point_t* point);
+
+void text_write_points(text_writer_t* writer, point_t* points, int npoints);
+
+int text_write_segment(void* sink, segment_t* seg, point_t* dp1,
+                       point_t* dp2);
+
+void text_write_segments(text_writer_t* writer, segment_t* edges, int nedges,
+                         point_t* sites);
+
+#endif
@@ -1,6 +1,7 @@
 import matplotlib.pyplot as plt
 import numpy as np
 import ast
+import struct
 
 from matplotlib.collections import LineCollection
 
@@ -15,13 +16,25 @@ def read_outputs(filename):
     segments = ast.literal_eval(segments)
     return vertices, segments
 
+def read_binary_outputs(filename):
+    fd = open(filename, "rb")
+    magic, version, nsites, nvertices, nedges = struct.unpack("<4sIQQQ", fd.read(32))
+    sites = np.fromfile(fd, dtype="<f8", count=2*nsites).reshape(-1, 2)
+    np.fromfile(fd, dtype="<f8", count=2*nvertices)
+    np.fromfile(fd, dtype="<i4", count=2*nedges)
+    duals = np.fromfile(fd, dtype="<i4", count=2*nedges).reshape(-1, 2)
+    return sites.tolist(), sites[duals]
+
 if __name__ == "__main__":
 
     fig, ax = plt.subplots()
     ax.set_xlim(-25, 25)
     ax.set_ylim(-25, 25)
 
-    points, segments = read_outputs("outputs.txt")
+    if open("outputs.txt", "rb").read(4) == b"VDGM":
+        points, segments = read_binary_outputs("outputs.txt")
+    else:
+        points, segments = read_outputs("outputs.txt")
     line_segments = LineCollection(segments, 
                                 linestyles='solid', linewidths = (0.3))
     ax.add_collection(line_segments)
@@ -8,46 +8,137 @@
  * @copyright Copyright (c) 2024
  * 
  */
+#define _POSIX_C_SOURCE 200809L
 #include "voronoi.h"
 #include "uarray.h"
+#include "parallel.h"
+#include "merge.h"
+#include "stats.h"
+#include <assert.h>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+
+/* state of a computation, everything the sweep allocates comes from here 
+   and is kept across resets so repeated computations reuse its capacity */
+struct voronoi_ctx {
+    beachline_t* beachline;
+    pqueue_t* events;
+    pool_t* event_pool;
+    segment_t* edges;
+    int nedges;
+    int edges_size;
+    event_t* sites;
+    int sites_size;
+    int next_tag;
+    int flags;
+    /* topology of the diagram, only built with VORONOI_DCEL */
+    point_t* vertices;
+    int nvertices;
+    int vertices_size;
+    voronoi_halfedge_t* halfedges;
+    voronoi_cell_t* cells;
+    int ncells;
+    int cells_size;
+    /* delaunay triangles, only built with VORONOI_TRIANGLES, with 
+       VORONOI_NEIGHBOURS every edge remembers the first corner of a 
+       triangle opposite to it until the second one links up with it */
+    int* triangles;
+    int* neighbours;
+    int ntriangles;
+    int triangles_size;
+    int* edge_corners;
+    /* rectangle the edges are clipped to as they are finalised when clip
+       is set, and the input points of the running computation, by which
+       the clipped edges are oriented */
+    box_t box;
+    int clip;
+    point_t* points;
+    /* cell polygons built by voronoi_polygons */
+    point_t* polygon_vertices;
+    int polygon_vertices_size;
+    int* polygon_offsets;
+    int polygon_offsets_size;
+    /* state of compute_voronoi_parallel, the sites are bucketed into slabs
+       and sorted by x, every slab being swept with a context of its own */
+    struct site_ref* refs;
+    point_t* sorted;
+    int sorted_size;
+    struct voronoi_ctx** slabs;
+    int slabs_size;
+    /* state of compute_voronoi_stream, an edge is handed to the sink as 
+       soon as both its ends are fixed, and its slot is reused for a later
+       edge, the sites of the dual of every edge slot are kept alongside it
+       since there is no array of the input points to index */
+    int (*emit)(void*, segment_t*, point_t*, point_t*);
+    void* sink;
+    int nemitted;
+    int sink_failed;
+    point_t* duals;
+    int* free_edges;
+    int nfree;
+    int free_size;
+    voronoi_timing_t timing;
+    voronoi_stats_t stats;
+};
+
+/* an input point and its index */
+struct site_ref {
+    point_t point;
+    int index;
+};
+
+/* a parallel computation, slab i holds the sorted sites [bounds[i], 
+   bounds[i + 1]) */
+struct slab_batch {
+    voronoi_ctx_t* ctx;
+    int* bounds;
+    /* number of distinct sites of every slab, which sorting moves to its
+       front */
+    int* sizes;
+    part_t* parts;
+    char* failed;
+    /* parts merged by a round are this far apart */
+    int stride;
+};
+
+typedef struct site_ref site_ref_t;
+typedef struct slab_batch slab_batch_t;
+
+/* label of the slot of an edge that has been handed to the sink */
+#define SEG_EMITTED 4
 
-
-int global_tag = 0;
 /***************/
 /* BOUNDARY    */
 /***************/
 
 /**
- * @brief This function initializes the boundary struct
+ * @brief threads a new boundary into the beachline right after a given 
+ *        node, the caller guarantees it belongs there
  * 
- * @param bound 
- * @param left_x 
- * @param left_y 
- * @param right_x 
- * @param right_y 
- * @param label 
+ * @param ctx state of the sweep
+ * @param pos node the boundary follows, NULL to make it the first
+ * @param left focus of the arc to the left of the boundary
+ * @param right focus of the arc to the right of the boundary
+ * @param left_site index of the input point of left
+ * @param right_site index of the input point of right
+ * @param edge index of the voronoi edge traced by the boundary
+ * @return beach_node_t* node of the boundary, NULL if allocation fails
  */
-void init_boundary(boundary_t* bound, double left_x, double left_y, 
-                   double right_x, double right_y, char label) {
-    bound->left_point.x = left_x;
-    bound->right_point.x = right_x;
-    bound->left_point.y = left_y;
-    bound->right_point.y = right_y;
-    bound->label = label;
-}
-
-
-boundary_t* new_boundary(double left_x, double left_y, double right_x,
-                         double right_y, char label) {
-    boundary_t* bound;
-    if (!(bound = malloc(sizeof(boundary_t)))) return NULL;
-    //printf("WELL IT IS %p\n", bound);
-    init_boundary(bound, left_x, left_y, right_x, right_y, label);
-    return bound;
-}
-
-void boundary_free(void* bound) {
-    free(bound);
+beach_node_t* new_boundary(voronoi_ctx_t* ctx, beach_node_t* pos,
+                           point_t* left, point_t* right, int left_site,
+                           int right_site, int edge) {
+    beach_node_t* node;
+    if (!(node = beachline_insert_after(ctx->beachline, pos))) return NULL;
+    point_copy(left, &node->bound.left_point);
+    point_copy(right, &node->bound.right_point);
+    node->bound.left_site = left_site;
+    node->bound.right_site = right_site;
+    node->bound.circle_event = NULL;
+    node->bound.edge = edge;
+    return node;
 }
 
 void boundary_print(void* elem) {
@@ -57,6 +148,327 @@ void boundary_print(void* elem) {
             bound->right_point.y, elem);
 }
 
+/***********/
+/*  DCEL   */
+/***********/
+
+/**
+ * @brief initializes one half of a new edge as a dangling half-edge of the
+ *        given cell, which is open on both ends until the sweep reaches its
+ *        vertices
+ * 
+ * @param ctx state of the sweep
+ * @param half index of the half-edge
+ * @param site index of the input point whose cell it bounds
+ */
+void init_halfedge(voronoi_ctx_t* ctx, int half, int site) {
+    voronoi_halfedge_t* h = &ctx->halfedges[half];
+    h->origin = -1;
+    h->twin = half ^ 1;
+    h->next = -1;
+    h->prev = -1;
+    h->cell = site;
+    ctx->cells[site].halfedge = half;
+}
+
+/**
+ * @brief appends a voronoi vertex to the topology of the diagram, events of
+ *        four or more cocircular sites are processed one after the other 
+ *        and share the vertex of the first one
+ * 
+ * @param ctx state of the sweep
+ * @param point location of the vertex
+ * @return int index of the vertex, -1 if allocation failed
+ */
+int new_vertex(voronoi_ctx_t* ctx, point_t* point) {
+    point_t* temp;
+    if (ctx->nvertices &&
+        point_equality(&ctx->vertices[ctx->nvertices - 1], point)) {
+        return ctx->nvertices - 1;
+    }
+    if (ctx->nvertices == ctx->vertices_size) {
+        int size = ctx->vertices_size ? 2 * ctx->vertices_size : 16;
+        if (!(temp = realloc(ctx->vertices, size * sizeof(point_t)))) {
+            return -1;
+        }
+        ctx->vertices = temp;
+        ctx->vertices_size = size;
+    }
+    point_copy(point, &ctx->vertices[ctx->nvertices]);
+    return ctx->nvertices++;
+}
+
+/**
+ * @brief returns the half-edge of an edge lying in the cell of a site
+ * 
+ * @param ctx state of the sweep
+ * @param edge index of the edge
+ * @param site index of one of the two sites of its dual
+ * @return int index of the half-edge
+ */
+int edge_half(voronoi_ctx_t* ctx, int edge, int site) {
+    return ctx->halfedges[2 * edge].cell == site ? 2 * edge : 2 * edge + 1;
+}
+
+/**
+ * @brief records a vertex at an end of the edge traced by a boundary, the 
+ *        left site of a boundary always lies to the right of the direction
+ *        in which it moves, so its half-edge runs against that direction
+ *        and the half-edge of the right site along it
+ * 
+ * @param ctx state of the sweep
+ * @param bound boundary tracing the edge
+ * @param vertex index of the vertex
+ * @param starts 1 if the boundary starts moving from the vertex, 0 if it 
+ *               ends there
+ */
+void boundary_vertex(voronoi_ctx_t* ctx, boundary_t* bound, int vertex,
+                     int starts) {
+    int site = starts ? bound->right_site : bound->left_site;
+    ctx->halfedges[edge_half(ctx, bound->edge, site)].origin = vertex;
+}
+
+/**
+ * @brief links two consecutive half-edges of a cell meeting at a vertex
+ * 
+ * @param ctx state of the sweep
+ * @param edge_in edge of the half-edge ending at the vertex
+ * @param edge_out edge of the half-edge leaving the vertex
+ * @param site index of the input point of the cell
+ */
+void link_halfedges(voronoi_ctx_t* ctx, int edge_in, int edge_out, int site) {
+    int in = edge_half(ctx, edge_in, site);
+    int out = edge_half(ctx, edge_out, site);
+    ctx->halfedges[in].next = out;
+    ctx->halfedges[out].prev = in;
+}
+
+/***********/
+/*TRIANGLES*/
+/***********/
+
+/**
+ * @brief appends the delaunay triangle of a voronoi vertex, every side of
+ *        the triangle is dual to one of the three edges meeting there
+ * 
+ * @param ctx state of the sweep
+ * @param sites indices of the input points of the corners, in 
+ *              counterclockwise order
+ * @param edges edge dual to the side opposite each corner
+ * @return int index of the triangle, -1 if allocation failed
+ */
+int new_triangle(voronoi_ctx_t* ctx, int sites[3], int edges[3]) {
+    int *temp, triangle, corner, other;
+    if (ctx->ntriangles == ctx->triangles_size) {
+        int size = ctx->triangles_size ? 2 * ctx->triangles_size : 16;
+        if (!(temp = realloc(ctx->triangles, 3 * size * sizeof(int)))) {
+            return -1;
+        }
+        ctx->triangles = temp;
+        if (ctx->flags & VORONOI_NEIGHBOURS) {
+            if (!(temp = realloc(ctx->neighbours, 3 * size * sizeof(int)))) {
+                return -1;
+            }
+            ctx->neighbours = temp;
+        }
+        ctx->triangles_size = size;
+    }
+    triangle = ctx->ntriangles++;
+    for (int k = 0; k < 3; k++) {
+        corner = 3 * triangle + k;
+        ctx->triangles[corner] = sites[k];
+        if (!(ctx->flags & VORONOI_NEIGHBOURS)) continue;
+        /* an edge has two ends, so at most two triangles lie across it */
+        ctx->neighbours[corner] = -1;
+        if ((other = ctx->edge_corners[edges[k]]) < 0) {
+            ctx->edge_corners[edges[k]] = corner;
+        } else {
+            ctx->neighbours[corner] = other / 3;
+            ctx->neighbours[other] = triangle;
+        }
+    }
+    return triangle;
+}
+
+/***********/
+/*  EDGES  */
+/***********/
+
+/**
+ * @brief appends a new dangling edge to the output of the computation, 
+ *        every edge is appended exactly once, when it is first traced by 
+ *        the beachline, and is completed in place as the sweep reaches its
+ *        vertices
+ * 
+ * @param ctx state of the sweep
+ * @param source_line bisector along which the edge runs
+ * @param dp1 first site of the dual delaunay edge, only kept when streaming
+ * @param dp2 second site of the dual delaunay edge, likewise
+ * @param site1 index of the input point of dp1
+ * @param site2 index of the input point of dp2
+ * @return int index of the new edge, -1 if allocation failed
+ */
+int new_edge(voronoi_ctx_t* ctx, line_t* source_line, point_t* dp1,
+             point_t* dp2, int site1, int site2) {
+    segment_t* temp;
+    voronoi_halfedge_t* halves;
+    point_t* duals;
+    int *corners, edge;
+    if (ctx->nfree > 0) {
+        edge = ctx->free_edges[--ctx->nfree];
+        segment_init(&ctx->edges[edge], source_line, site1, site2);
+        point_copy(dp1, &ctx->duals[2 * edge]);
+        point_copy(dp2, &ctx->duals[2 * edge + 1]);
+        return edge;
+    }
+    if (ctx->nedges == ctx->edges_size) {
+        int size = ctx->edges_size ? 2 * ctx->edges_size : 16;
+        if (!(temp = realloc(ctx->edges, size * sizeof(segment_t)))) {
+            return -1;
+        }
+        ctx->edges = temp;
+        if (ctx->flags & VORONOI_DCEL) {
+            if (!(halves = realloc(ctx->halfedges,
+                                   2 * size * sizeof(voronoi_halfedge_t)))) {
+                return -1;
+            }
+            ctx->halfedges = halves;
+        }
+        if (ctx->emit) {
+            if (!(duals = realloc(ctx->duals, 2 * size * sizeof(point_t)))) {
+                return -1;
+            }
+            ctx->duals = duals;
+        }
+        if (ctx->flags & VORONOI_NEIGHBOURS) {
+            if (!(corners = realloc(ctx->edge_corners, size * sizeof(int)))) {
+                return -1;
+            }
+            ctx->edge_corners = corners;
+        }
+        ctx->edges_size = size;
+    }
+    edge = ctx->nedges++;
+    segment_init(&ctx->edges[edge], source_line, site1, site2);
+    if (ctx->emit) {
+        point_copy(dp1, &ctx->duals[2 * edge]);
+        point_copy(dp2, &ctx->duals[2 * edge + 1]);
+    }
+    if (ctx->flags & VORONOI_DCEL) {
+        init_halfedge(ctx, 2 * edge, site1);
+        init_halfedge(ctx, 2 * edge + 1, site2);
+    }
+    if (ctx->flags & VORONOI_NEIGHBOURS) ctx->edge_corners[edge] = -1;
+    return edge;
+}
+
+/**
+ * @brief returns a site of the dual of an edge
+ * 
+ * @param ctx state of the sweep
+ * @param edge index of the edge
+ * @param site index of the site, 0 for dual.site1 and 1 for dual.site2
+ * @return point_t* the site
+ */
+point_t* edge_site(voronoi_ctx_t* ctx, int edge, int site) {
+    segment_t* seg = &ctx->edges[edge];
+    if (ctx->emit) return &ctx->duals[2 * edge + site];
+    return &ctx->points[site ? seg->dual.site2 : seg->dual.site1];
+}
+
+/**
+ * @brief clips an edge to the clip rectangle, the resulting segment runs
+ *        with the first site of its dual on its left, as the half-edge of
+ *        that site does
+ * 
+ * @param ctx state of the sweep
+ * @param edge index of the edge
+ * @param dir direction of a ray, from its point towards infinity, ignored 
+ *            for segments and lines
+ */
+void edge_clip(voronoi_ctx_t* ctx, int edge, point_t* dir) {
+    segment_t* seg = &ctx->edges[edge];
+    point_t *site1 = edge_site(ctx, edge, 0);
+    point_t *site2 = edge_site(ctx, edge, 1);
+    point_t normal, mid, p1;
+
+    /* the bisector runs along the normal of its sites */
+    normal.x = site1->y - site2->y;
+    normal.y = site2->x - site1->x;
+    compute_midpoint(site1, site2, &mid);
+    segment_clip(seg, &ctx->box, &mid, seg->label == SEG_LINE ? &normal : dir);
+    if (seg->label != SEG_SEG) return;
+    if ((SEG_POINT2(seg)->x - SEG_POINT1(seg)->x) * normal.x +
+        (SEG_POINT2(seg)->y - SEG_POINT1(seg)->y) * normal.y < 0) {
+        point_copy(SEG_POINT1(seg), &p1);
+        point_copy(SEG_POINT2(seg), SEG_POINT1(seg));
+        point_copy(&p1, SEG_POINT2(seg));
+    }
+}
+
+/**
+ * @brief clips the edges still unbounded once the sweep is done, the 
+ *        boundaries left on the beachline trace them towards infinity,
+ *        every other ray started at a vertex below the topmost sites, 
+ *        whose boundary moved straight down from infinity, so it points
+ *        straight up
+ * 
+ * @param ctx state of the sweep
+ */
+void clip_unbounded(voronoi_ctx_t* ctx) {
+    beach_node_t* node;
+    boundary_t* bound;
+    point_t dir, up = {0, 1};
+
+    for (node = beachline_first(ctx->beachline); node; node = node->next) {
+        bound = &node->bound;
+        /* the left site lies to the right of the direction it moves in */
+        dir.x = bound->right_point.y - bound->left_point.y;
+        dir.y = bound->left_point.x - bound->right_point.x;
+        if (ctx->edges[bound->edge].label == SEG_RAY ||
+            ctx->edges[bound->edge].label == SEG_LINE) {
+            edge_clip(ctx, bound->edge, &dir);
+        }
+    }
+    for (int i = 0; i < ctx->nedges; i++) {
+        if (ctx->edges[i].label == SEG_RAY) edge_clip(ctx, i, &up);
+    }
+}
+
+/**
+ * @brief fixes an end of an edge at a voronoi vertex, an edge whose ends 
+ *        are both fixed is final, so it is clipped right away if the 
+ *        context clips, and when streaming, handed to the sink and its slot
+ *        freed
+ * 
+ * @param ctx state of the sweep
+ * @param edge index of the edge
+ * @param vertex 
+ */
+void edge_vertex(voronoi_ctx_t* ctx, int edge, point_t* vertex) {
+    segment_t* seg = &ctx->edges[edge];
+    int* temp;
+
+    segment_transform(seg, vertex);
+    if (seg->label != SEG_SEG) return;
+    if (ctx->clip) edge_clip(ctx, edge, NULL);
+    if (!ctx->emit) return;
+    if (seg->label == SEG_SEG) {
+        if (ctx->emit(ctx->sink, seg, &ctx->duals[2 * edge],
+                      &ctx->duals[2 * edge + 1])) ctx->sink_failed = 1;
+        ctx->nemitted++;
+    }
+    seg->label = SEG_EMITTED;
+    if (ctx->nfree == ctx->free_size) {
+        int size = ctx->free_size ? 2 * ctx->free_size : 16;
+        /* without room to recycle it, the slot is simply left unused */
+        if (!(temp = realloc(ctx->free_edges, size * sizeof(int)))) return;
+        ctx->free_edges = temp;
+        ctx->free_size = size;
+    }
+    ctx->free_edges[ctx->nfree++] = edge;
+}
+
 /***********/
 /*  EVENTS */
 /***********/
@@ -65,37 +477,43 @@ void event_print(void* e) {
     event_t* event = (event_t*) e;
     printf("(%.8f, %.8f)\n ", event->sweep_event.x, event->sweep_event.y);
     if (event->label == CIRCLE_EVENT) {
-        point_print(event->triplet.left, "L");
-        point_print(event->triplet.mid, "M");
-        point_print(event->triplet.right, "R");
+        printf("L: %d M: %d R: %d\n", event->triplet.left, event->triplet.mid,
+               event->triplet.right);
     }
 }
 
-void init_event(event_t* e, char label, double x, double y, point_t* left, 
-                point_t* mid, point_t* right) {
+/**
+ * @brief initializes an event, sites leave the triplet at -1
+ * 
+ * @param e event to be initialized
+ * @param tag tie breaker between events at the same point, in order of 
+ *            creation
+ * @param label SITE_EVENT or CIRCLE_EVENT
+ * @param x x-value of the event point
+ * @param y y-value of the event point
+ * @param left index of the left site of a circle event, -1 for site events
+ * @param mid index of the middle site of a circle event, -1 for site events
+ * @param right index of the right site of a circle event, -1 for site events
+ */
+void init_event(event_t* e, int tag, char label, double x, double y,
+                int left, int mid, int right) {
     e->label = label;
     e->sweep_event.x = x;
     e->sweep_event.y = y;
-    e->triplet.left = NULL;
-    e->triplet.mid = NULL;
-    e->triplet.right = NULL;
-    if (left && (e->triplet.left = malloc(sizeof(point_t)))) {
-        point_copy(left, e->triplet.left);
-    } 
-    if (mid && (e->triplet.mid = malloc(sizeof(point_t)))) {
-        point_copy(mid, e->triplet.mid);
-    } 
-    if (right && (e->triplet.right = malloc(sizeof(point_t)))) {
-        point_copy(right, e->triplet.right);
-    } 
-    e->tag = global_tag++;
+    e->site = -1;
+    e->arc = NULL;
+    e->slot = -1;
+    e->triplet.left = left;
+    e->triplet.mid = mid;
+    e->triplet.right = right;
+    e->tag = tag;
 }
 
-event_t* new_event(char label, double x, double y, point_t* left, 
-                point_t* mid, point_t* right) {
+event_t* new_event(pool_t* pool, int tag, char label, double x, double y,
+                   int left, int mid, int right) {
     event_t* e;
-    if ((e = malloc(sizeof(event_t))) == NULL) return NULL;
-    init_event(e, label, x, y, left, mid, right);
+    if ((e = pool_alloc(pool)) == NULL) return NULL;
+    init_event(e, tag, label, x, y, left, mid, right);
     return e;
 }
 
@@ -114,476 +532,1554 @@ int event_compare(void* e1, void* e2) {
     return -1;
 }
 
-void event_free(event_t* event) {
-    if (event->triplet.left) free(event->triplet.left);
-    if (event->triplet.mid) free(event->triplet.mid);
-    if (event->triplet.right) free(event->triplet.right);
-    free(event);
-}
-
 /**
- * @brief tests if a given circle event at a given sweep depth is valid or
- *        if it has otherwise been made redundant by an earlier event
+ * @brief gives the event queue access to the slot stored in an event
  * 
- * @param e circle event to be tested 
- * @param beachline binary tree representing the beachline
- * @param sweep the y-value of the sweepline
- * @return int 0 if valid, 1 if not valid
+ * @param e event
+ * @return int* address of the event's slot
  */
-int is_circle_event_stale(event_t* e, bst_t* beachline, double sweep) {
-    double beachline_x, beachline_y;
-    point_t* focus;
-    circle_t event_circle;
-    boundary_t bound, *left = NULL, *right = NULL;
-    void* arg = DOUBLE2VOID(sweep);
-
-    beachline_x = e->sweep_event.x;
-
-    /* we want to find under which arc does the circle center lie */
-    init_boundary(&bound, beachline_x, sweep, beachline_x, sweep,
-                  SINGLETON);
-    bst_interval(beachline, &bound, (void**) &left,
-                 (void**) &right, arg);
-
-
-    /* the invariant maintains that the left intersection's right will always
-       be the right intersection's left, and at least one of them will be 
-       non-NULL */
-    if (left) focus = &left->right_point;
-    if (right) focus = &right->left_point;
-
-    /* we compute the y value on the beachline at that point, so that we can
-       tell if the circumcircle's center is behind or on the beachline, if it 
-       is behind it means that this circle event is no longer valid */
-
-    beachline_y = compute_parabola_value(focus, sweep, beachline_x);
-
-    compute_circumcircle(e->triplet.left, e->triplet.mid, e->triplet.right,
-                         &event_circle);
+int* event_slot(void* e) {
+    return &((event_t*) e)->slot;
+}
 
-    return (event_circle.center.y > beachline_y);
+void event_free(pool_t* pool, event_t* event) {
+    pool_release(pool, event);
 }
 
-void new_circle_event(pqueue_t* events, boundary_t* neighbour, point_t* site,
-                      char side, char original_event, double sweep) {
-    point_t point;
+/**
+ * @brief schedules the circle event of the arc to the right of a boundary,
+ *        if the arc is converging, the event is owned by the boundary so 
+ *        that it can be cancelled once the arc changes
+ * 
+ * @param ctx state of the sweep
+ * @param owner beachline node of the left boundary of the dissolving arc
+ * @param neighbour boundary neighbouring the new site
+ * @param site site forming the third point of the circle event
+ * @param site_idx index of the input point of the site
+ * @param side side of the site on which the neighbour lies
+ * @return int 0 on success, whether or not the arc converges, -1 if 
+ *         allocation failed
+ */
+int new_circle_event(voronoi_ctx_t* ctx, beach_node_t* owner,
+                     boundary_t* neighbour, point_t* site, int site_idx,
+                     char side) {
+    circle_t circle;
+    double y;
     event_t* event;
+    boundary_t* bound = &owner->bound;
 
-    if (compute_circle_tangent(&neighbour->left_point, &neighbour->right_point,
-                           site, &point)) return;
-
-    if (original_event == CIRCLE_EVENT && point.y >= sweep) return;
+    assert(bound->circle_event == NULL);
+    if (compute_circumcircle(&neighbour->left_point, &neighbour->right_point,
+                             site, &circle)) return 0;
 
+    /* the event happens when the sweep line touches the bottom of the 
+       circle */
+    y = circle.center.y - circle.radius;
     if (side == LEFT_SIDE) {
-        event = new_event(CIRCLE_EVENT, point.x, point.y,
-                          &neighbour->left_point, &neighbour->right_point,
-                          site);
+        event = new_event(ctx->event_pool, ctx->next_tag++, CIRCLE_EVENT,
+                          circle.center.x, y, neighbour->left_site,
+                          neighbour->right_site, site_idx);
 
     } else {
-        event = new_event(CIRCLE_EVENT, point.x, point.y, site,
-                          &neighbour->left_point, &neighbour->right_point);
+        event = new_event(ctx->event_pool, ctx->next_tag++, CIRCLE_EVENT,
+                          circle.center.x, y, site_idx, neighbour->left_site,
+                          neighbour->right_site);
 
     }
+    if (event == NULL) return -1;
+    event->arc = owner;
+    point_copy(&circle.center, &event->center);
 
-    pqueue_insert(events, (void*) event);
+    if (pqueue_insert(ctx->events, (void*) event)) {
+        event_free(ctx->event_pool, event);
+        return -1;
+    }
+    bound->circle_event = event;
+    STAT(if (pqueue_size(ctx->events) > ctx->stats.max_events) {
+        ctx->stats.max_events = pqueue_size(ctx->events);
+    })
+    return 0;
 }
 
-
-/** 
- * @brief 
+/**
+ * @brief cancels the pending circle event of the arc to the right of a 
+ *        boundary, since that arc has been split or lost a neighbour, the
+ *        event is taken out of the queue right away
  * 
- * @param elem1 
- * @param elem2 
- * @param args 
- * @return int 0 if (elem1 == elem2), 1 if (elem1 < elem2) and -1 if (elem1 > elem2)
- */
-int beachline_compare(void* elem1, void* elem2, void* args) {
-    point_t intersect1, intersect2;
-    boundary_t* bound1 = (boundary_t*) elem1;
-    boundary_t* bound2 = (boundary_t*) elem2;
-    double* t = (double*) &args;
-    double sweepline =  *t;
-    if (bound1->label == SINGLETON) {
-        intersect1.x = bound1->left_point.x;
-    } else {
-        compute_arc_intersection(&bound1->left_point, &bound1->right_point,
-                             sweepline, &intersect1);
-    }
-
-    if (bound2->label == SINGLETON) {
-        intersect2.x = bound2->left_point.x;
-    } else {          
-        compute_arc_intersection(&bound2->left_point, &bound2->right_point,
-                             sweepline, &intersect2);
-    }
-
-    if (intersect2.x == intersect1.x) return 0;
-    return SYMMETRIC_LEQ(intersect1.x, intersect2.x);
+ * @param ctx state of the sweep
+ * @param node beachline node of the boundary, may be NULL
+ */
+void cancel_circle_event(voronoi_ctx_t* ctx, beach_node_t* node) {
+    boundary_t* bound;
+    if (node == NULL) return;
+    bound = &node->bound;
+    if (bound->circle_event == NULL) return;
+    pqueue_remove(ctx->events, bound->circle_event);
+    event_free(ctx->event_pool, bound->circle_event);
+    bound->circle_event = NULL;
+    STAT(ctx->stats.stale_circle_events++);
 }
 
-double beachline_diff(void* elem1, void* elem2, void* args) {
-    point_t intersect1, intersect2;
-    boundary_t* bound1 = (boundary_t*) elem1;
-    boundary_t* bound2 = (boundary_t*) elem2;
-    double* t = (double*) &args;
-    double sweepline =  *t;
-    if (bound1->label == SINGLETON) {
-        intersect1.x = bound1->left_point.x;
-    } else {
-        compute_arc_intersection(&bound1->left_point, &bound1->right_point,
-                             sweepline, &intersect1);
-    }
 
-    if (bound2->label == SINGLETON) {
-        intersect2.x = bound2->left_point.x;
-    } else {          
-        compute_arc_intersection(&bound2->left_point, &bound2->right_point,
-                             sweepline, &intersect2);
-    }
+/**
+ * @brief tests whether a boundary is the intersection of the given two arcs
+ *        in the given order
+ * 
+ * @param bound boundary to be tested
+ * @param left index of the site of the arc to the left of the boundary
+ * @param right index of the site of the arc to the right of the boundary
+ * @return int 1 if it is, 0 otherwise
+ */
+int boundary_equality(boundary_t* bound, int left, int right) {
+    return bound->left_site == left && bound->right_site == right;
+}
 
-    if (intersect2.x > intersect1.x) return intersect2.x - intersect1.x;
-    return intersect1.x - intersect2.x;
+/**
+ * @brief takes a boundary off the beachline
+ * 
+ * @param ctx state of the sweep
+ * @param node beachline node of the boundary
+ */
+void remove_boundary(voronoi_ctx_t* ctx, beach_node_t* node) {
+    beachline_remove(ctx->beachline, node);
 }
 
-int process_intersection_site(bst_t* beachline, pqueue_t* events, bst_t* voronoi,
-                              point_t* site, double sweep) {
-    boundary_t temp, temp_left, temp_right;
-    boundary_t *left, *right, *new_left, *new_right, *new_bound, *dummy;
+int process_intersection_site(voronoi_ctx_t* ctx, beach_node_t* node,
+                              point_t* site, int site_idx) {
+    boundary_t *new_left, *new_right, *old_bound;
+    beach_node_t *left_node, *right_node;
+    point_t left_point, right_point;
     line_t source_line;
     circle_t voronoi_vertex;
-    segment_t *seg, *new_edge;
-    void* arg = DOUBLE2VOID(sweep);
-    double lower_sweep = sweep - EPSILON;
-    void* lower_arg = DOUBLE2VOID(lower_sweep);
+    int edge, left_edge, left_site, right_site, old_edge, vertex = -1;
+
+    /* the site lies right underneath this intersection, its neighbours are
+       the boundaries of the two arcs that meet there, both of which now get
+       a new neighbour in the site */
+    left_node = node->prev;
+    right_node = node->next;
+    new_left = left_node ? &left_node->bound : NULL;
+    new_right = right_node ? &right_node->bound : NULL;
+    cancel_circle_event(ctx, left_node);
+    cancel_circle_event(ctx, node);
 
     /* we directly delete the intersection between the two arcs */
-    init_boundary(&temp, site->x - EPSILON, site->y,
-                            site->x - EPSILON, site->y, SINGLETON);
-    bst_interval(beachline, &temp, (void**) &left, (void**) &right, arg);
-    bst_delete(beachline, right, (void**) &seg, arg);
-
-    init_boundary(&temp_left,  site->x - EPSILON, sweep,
-                        site->x  - EPSILON, sweep, SINGLETON);
-    init_boundary(&temp_right, site->x + EPSILON, sweep,
-                        site->x  + EPSILON, sweep, SINGLETON);
-
-    /* we only care about the left boundary */
-    bst_interval(beachline, &temp_left, (void**) &new_left,
-                (void**) &dummy, arg);
-    /* we only care about the right boundary */
-    bst_interval(beachline, &temp_right, (void**) &dummy,
-                (void**) &new_right, arg);
-
-    if (new_left) {
-        new_circle_event(events, new_left, site, LEFT_SIDE,
-                            CIRCLE_EVENT, sweep);
-    }
-    if (new_right) {
-        new_circle_event(events, new_right, site, RIGHT_SIDE,
-                        CIRCLE_EVENT, sweep);
-    }
+    old_bound = &node->bound;
+    point_copy(&old_bound->left_point, &left_point);
+    point_copy(&old_bound->right_point, &right_point);
+    left_site = old_bound->left_site;
+    right_site = old_bound->right_site;
+    old_edge = old_bound->edge;
 
     /* we compute the voronoi vertex that results from the new site and the
        two sites at the intersection */
-    compute_circumcircle(&right->left_point, site,
-                         &right->right_point, &voronoi_vertex);
-    segment_transform(seg, &voronoi_vertex.center);
-    bst_insert(voronoi, seg, NULL, NULL);
+    compute_circumcenter(&left_point, site, &right_point, &voronoi_vertex);
+    edge_vertex(ctx, old_edge, &voronoi_vertex.center);
+    if (ctx->flags & VORONOI_DCEL) {
+        if ((vertex = new_vertex(ctx, &voronoi_vertex.center)) < 0) return -1;
+        boundary_vertex(ctx, old_bound, vertex, 0);
+    }
+    remove_boundary(ctx, node);
 
     /* we compute the new boundary for the site and the left point, and 
        add a new dangling edge for the left side */
-    compute_bisector(&right->left_point, site, &source_line);
-    new_edge = segment_new(&source_line, &right->left_point, site);
-    segment_transform(new_edge, &voronoi_vertex.center);
-    new_bound = new_boundary(right->left_point.x, right->left_point.y,
-                             site->x, site->y, INTERSECT);
-    bst_insert(beachline, new_bound, new_edge, lower_arg);
+    compute_bisector(&left_point, site, &source_line);
+    if ((left_edge = new_edge(ctx, &source_line, &left_point, site,
+                              left_site, site_idx)) < 0) return -1;
+    edge_vertex(ctx, left_edge, &voronoi_vertex.center);
+    if (!(node = new_boundary(ctx, left_node, &left_point, site, left_site,
+                              site_idx, left_edge))) return -1;
+    if (ctx->flags & VORONOI_DCEL) {
+        boundary_vertex(ctx, &node->bound, vertex, 1);
+        link_halfedges(ctx, left_edge, old_edge, left_site);
+    }
 
     /* we compute the new boundary for the site and the right point, and 
        add a new dangling edge for the right side */
-    compute_bisector(&right->right_point, site, &source_line);
-    new_edge = segment_new(&source_line, site, &right->right_point);
-    segment_transform(new_edge, &voronoi_vertex.center);
-    new_bound = new_boundary(site->x, site->y, right->right_point.x,
-                             right->right_point.y,  INTERSECT);
-    bst_insert(beachline, new_bound, new_edge, lower_arg);
+    compute_bisector(&right_point, site, &source_line);
+    if ((edge = new_edge(ctx, &source_line, site, &right_point, site_idx,
+                         right_site)) < 0) return -1;
+    edge_vertex(ctx, edge, &voronoi_vertex.center);
+    if (!(node = new_boundary(ctx, node, site, &right_point, site_idx,
+                              right_site, edge))) return -1;
+    if (ctx->flags & VORONOI_DCEL) {
+        boundary_vertex(ctx, &node->bound, vertex, 1);
+        link_halfedges(ctx, old_edge, edge, right_site);
+        link_halfedges(ctx, edge, left_edge, site_idx);
+    }
+    /* the site lies below the other two, on the circle through them */
+    if (ctx->flags & VORONOI_TRIANGLES) {
+        int corners[3] = {left_site, site_idx, right_site};
+        int sides[3] = {edge, old_edge, left_edge};
+        if (new_triangle(ctx, corners, sides) < 0) return -1;
+    }
+
+    if (new_left &&
+        new_circle_event(ctx, left_node, new_left, site, site_idx, LEFT_SIDE)) {
+        return -1;
+    }
+    if (new_right &&
+        new_circle_event(ctx, node, new_right, site, site_idx, RIGHT_SIDE)) {
+        return -1;
+    }
     
     return 0;
 }
 
-int process_site(bst_t* beachline, pqueue_t* events,  bst_t* voronoi,
-                     point_t* site, double sweep) {
-    boundary_t temp;
-    boundary_t *left, *right,  *new_bound;
+int process_site(voronoi_ctx_t* ctx, point_t* site, int site_idx) {
+    boundary_t *left, *right;
+    beach_node_t *left_node, *right_node, *site_node;
     line_t source_line;
     point_t* arc_point;
-    segment_t* new_edge;
-    double lower_sweep = sweep - EPSILON;
-    double right_diff, left_diff;
-    void* arg = DOUBLE2VOID(sweep);
-    void* lower_arg = DOUBLE2VOID(lower_sweep);
-
-    init_boundary(&temp, site->x, site->y, site->x, site->y, SINGLETON);
+    int edge, arc_site;
 
     /* we first check if the site lies directly underneath an intersection of 
        two arcs, if so we process this in a similar manner to a circle event */
-    if (!bst_find(beachline, (void*) &temp, NULL, arg)) {
-        return process_intersection_site(beachline, events, voronoi, site, sweep);
+    if (beachline_locate(ctx->beachline, site, &left_node, &right_node)
+        == KEY_FOUND) {
+        return process_intersection_site(ctx, left_node, site, site_idx);
     }
 
     /* if we are unable to find boundaries to our left or our right, it means
        that the beachline is empty  */
-    if (bst_interval(beachline, &temp, (void**) &left, (void**) &right, arg)) {
-        return -1;
-    }
+    if (!left_node && !right_node) return -1;
+    left = left_node ? &left_node->bound : NULL;
+    right = right_node ? &right_node->bound : NULL;
 
 
     /* INVARIANT: if left and right not NULL, left->right == right->left */
     /* the invariant maintains that the left intersection's right will always
        be the right intersection's left, and at least one of them will be 
        non-NULL */
+    arc_point = right ? &right->left_point : &left->right_point;
+    arc_site = right ? right->left_site : left->right_site;
 
-    /* this conditional handles the case where the new site lies between 
-       the intersection of the same two arcs, just in different orientation, 
-       since the two arcs have the same two points, they can only yield one 
-       new circle event, and the orientation of the points is decided based 
-       on the proximity to one of the insersections */
-    if (left && right && point_equality(&left->right_point, &right->left_point)
-        && point_equality(&left->left_point, &right->right_point)) {
-        arc_point = &left->right_point; /* or &right->left_point*/
-        right_diff = beachline_diff(right, &temp, arg);
-        left_diff = beachline_diff(left, &temp, arg);
-    
-        /* TODO: possibly replace with atan2 check of two bisectors? */
-        if (left_diff < right_diff) {
-            new_circle_event(events, left, site, LEFT_SIDE, SITE_EVENT, sweep);
-        } else {
-            new_circle_event(events, right, site, RIGHT_SIDE, SITE_EVENT, sweep);
-        }
-    } else {
-        
-        /* this part handles the case where the two intersections (if present) 
-           are of different points, and hence we get possibly 
-           two circle events */
-        if (left != NULL) {
-            arc_point = &left->right_point;
-            new_circle_event(events, left, site, LEFT_SIDE, SITE_EVENT, sweep);
-        } 
-        
-        if (right != NULL) {
-            arc_point = &right->left_point; /* even if both not NULL, by invariant still equal */
-            new_circle_event(events, right, site, RIGHT_SIDE, SITE_EVENT, sweep);
-        }
-    }
+    /* the arc above the site is split, so its pending circle event is no 
+       longer valid */
+    cancel_circle_event(ctx, left_node);
 
     /* since the new site is going to lie under a parabola, we need to figure 
        out the line that goes through the insercetion of the parent parabola 
        and the new site paraobla, this will become a voronoi edge */
     compute_bisector(arc_point, site, &source_line);
-    new_edge = segment_new(&source_line, arc_point, site);
+    edge = new_edge(ctx, &source_line, arc_point, site, arc_site, site_idx);
+    if (edge < 0) return -1;
 
+    /* the new boundaries all lie between the left and right neighbours, so 
+       they are threaded in right after the left one */
     /* if the parent parabola is on the same y level, then there will only 
        be one intersection */
     if (arc_point->y == site->y) {
-        double min_x = arc_point->x < site->x ? arc_point->x : site->x;
-        double max_x = arc_point->x < site->x ? site->x : arc_point->x;
-        new_bound = new_boundary(min_x, arc_point->y, max_x, site->y, INTERSECT);
-        bst_insert(beachline, new_bound, new_edge, arg);
+        if (arc_point->x < site->x) {
+            site_node = new_boundary(ctx, left_node, arc_point, site, arc_site,
+                                     site_idx, edge);
+        } else {
+            site_node = new_boundary(ctx, left_node, site, arc_point, site_idx,
+                                     arc_site, edge);
+        }
     } else {
         /*otherwise, we would have two intersections as the sweepline goes 
-          down, and hence we need to add both boundaries, note how we offset
-          the sweepline slightly down so that the two intersections become 
-          distinguishable */
-        new_bound = new_boundary(arc_point->x, arc_point->y,
-                                 site->x, site->y, INTERSECT);
-        bst_insert(beachline, new_bound, new_edge, lower_arg);
-        new_bound = new_boundary(site->x, site->y, 
-                                arc_point->x, arc_point->y, INTERSECT);
-        bst_insert(beachline, new_bound, new_edge, lower_arg);
+          down, the one with the parent arc on its left comes first */
+        site_node = new_boundary(ctx, left_node, arc_point, site, arc_site,
+                                 site_idx, edge);
+        if (site_node) {
+            site_node = new_boundary(ctx, site_node, site, arc_point,
+                                     site_idx, arc_site, edge);
+        }
+    }
+    if (!site_node) return -1;
+
+    /* the circle event on the left belongs to the left piece of the split 
+       arc, and the one on the right to the right piece, which starts at the
+       last boundary inserted, the arcs converge on at most one of them if
+       the split arc lies between two arcs of the same site, which the 
+       orientation test of the circle decides */
+    if (left != NULL &&
+        new_circle_event(ctx, left_node, left, site, site_idx, LEFT_SIDE)) {
+        return -1;
+    } 
+    
+    if (right != NULL &&
+        new_circle_event(ctx, site_node, right, site, site_idx, RIGHT_SIDE)) {
+        return -1;
     }
 
     return 0;
 }
 
-int process_circle_event(bst_t* beachline, pqueue_t* events, bst_t* voronoi, event_t* e, 
-                         double sweep) {
-    circle_t voronoi_vertex;
-    boundary_t left, right, *dummy, *new_left, *new_right, *new_bound;
-    point_t *leftp, *midp, *rightp;
-    segment_t *leftseg, *rightseg, *edge;
+int process_circle_event(voronoi_ctx_t* ctx, event_t* e) {
+    boundary_t *new_left, *new_right;
+    beach_node_t *left_node, *right_node, *node;
+    point_t left, mid, right, center;
+    int edge, left_edge, right_edge, left_site, mid_site, right_site;
+    int vertex = -1;
     line_t source_line;
-    void* arg = DOUBLE2VOID(sweep);
-
-    leftp = e->triplet.left;
-    rightp = e->triplet.right;
-    midp = e->triplet.mid;
 
-    /* if the circle event is stale, i.e. another site came before in between,
-        then just ignore */
-    if (is_circle_event_stale(e, beachline, sweep)) return -1;
-
-    /* computes the vertex that is to be added to the voronoi diagram, if 
-       this circle event happens to be impossible (the bisectors diverge or 
-       are parellel) we do not proceed */
-    if (compute_circumcircle(leftp, midp, rightp, &voronoi_vertex)) return -1;
-
-    /* we need to remove the two pairs containing the middle point since
-      the arc between has now dissolved */
-    init_boundary(&left, leftp->x, leftp->y, midp->x, midp->y, INTERSECT);
-    init_boundary(&right, midp->x, midp->y, rightp->x, rightp->y, INTERSECT);
-
-    /* if the two pairs are not on the beachline, it means that some other 
-       circle event beat us to the dissolution, meaning this event is stale*/
-    if (bst_find(beachline, (void*) &left, (void**) &leftseg, arg) ||
-        bst_find(beachline, (void*) &right, (void**) &rightseg, arg)) return -1;
+    left_site = e->triplet.left;
+    mid_site = e->triplet.mid;
+    right_site = e->triplet.right;
+
+    /* events are cancelled as soon as their arc changes, so the two 
+       boundaries of the dissolving arc are still adjacent on the beachline,
+       starting at the node the event was scheduled on, the sites are copied
+       out of them before they are removed */
+    left_node = e->arc;
+    right_node = left_node->next;
+    left_node->bound.circle_event = NULL;
+    assert(boundary_equality(&left_node->bound, left_site, mid_site));
+    assert(boundary_equality(&right_node->bound, mid_site, right_site));
+    point_copy(&left_node->bound.left_point, &left);
+    point_copy(&left_node->bound.right_point, &mid);
+    point_copy(&right_node->bound.right_point, &right);
+
+    /* the vertex is the center computed when the event was scheduled, from
+       the rotation of the sites whose convergence was checked then, another
+       rotation could round differently or fail the check */
+    point_copy(&e->center, &center);
+
+    left_edge = left_node->bound.edge;
+    right_edge = right_node->bound.edge;
+
+    /* both boundaries of the dissolved arc end at the vertex, the half-edges
+       of the middle cell meet there */
+    if (ctx->flags & VORONOI_DCEL) {
+        if ((vertex = new_vertex(ctx, &center)) < 0) return -1;
+        boundary_vertex(ctx, &left_node->bound, vertex, 0);
+        boundary_vertex(ctx, &right_node->bound, vertex, 0);
+        link_halfedges(ctx, left_edge, right_edge, mid_site);
+    }
 
-    /* this part should not exist in theory, however it handles a bug 
-       that sometimes appear with the second delete */
-    /* TODO: fix second delete bug */
-    if (bst_delete(beachline, (void*) &left, (void**) &leftseg, arg)) return -1;
-    if (bst_delete(beachline, (void*) &right, (void**) &rightseg, arg)) return -1;
+    /* the boundaries neighbouring the dissolved arc become the neighbours of
+       the new boundary, which takes the place of the two removed ones, the 
+       arcs on either side lose a neighbour so their events are cancelled */
+    left_node = left_node->prev;
+    new_left = left_node ? &left_node->bound : NULL;
+    new_right = right_node->next ?
+                &right_node->next->bound : NULL;
+    cancel_circle_event(ctx, left_node);
+    cancel_circle_event(ctx, right_node);
+    remove_boundary(ctx, right_node->prev);
+    remove_boundary(ctx, right_node);
 
     /* transforms what previously was a line into a ray, or what was prevously 
        was a ray into a segment, since now we hit a new voronoi vertex */
-    segment_transform(leftseg, &voronoi_vertex.center);
-    segment_transform(rightseg, &voronoi_vertex.center);
-
-    /* if the segment is a line segment and is not already in the voronoi set,
-       add it */
-    if (leftseg->label == SEG_SEG && bst_find(voronoi, leftseg, NULL, NULL)) 
-            bst_insert(voronoi, leftseg, NULL, NULL);
-    if (rightseg->label == SEG_SEG && bst_find(voronoi, rightseg, NULL, NULL)) 
-            bst_insert(voronoi, rightseg, NULL, NULL);
-  
-
-
-    /* now for the left and right points, we need to find their left and right
-      points respectively, so that we add the two potential circle events*/
-    init_boundary(&left, e->sweep_event.x - EPSILON, sweep,
-                         e->sweep_event.x - EPSILON, sweep, SINGLETON);
-    init_boundary(&right, e->sweep_event.x + EPSILON, sweep,
-                          e->sweep_event.x + EPSILON, sweep, SINGLETON);
-
-    /* we only care about the left boundary */
-    bst_interval(beachline, &left, (void**) &new_left,
-                 (void**) &dummy, arg);
-    /* we only care about the right boundary */
-    bst_interval(beachline, &right, (void**) &dummy,
-                (void**) &new_right, arg);
+    edge_vertex(ctx, left_edge, &center);
+    edge_vertex(ctx, right_edge, &center);
 
     /* inserting the new pair (arc intersection) after the middle point is 
       removed, there is only one such pair, we also add a new dangling edge 
       for this new boundary formed from the left and the right point of the 
       circle event */
-    new_bound = new_boundary(leftp->x, leftp->y, rightp->x, rightp->y,
-                             INTERSECT);
-    compute_bisector(leftp, rightp, &source_line);
-    edge = segment_new(&source_line, leftp, rightp);
-    segment_transform(edge, &voronoi_vertex.center);
-    bst_insert(beachline, new_bound, edge, arg);
+    compute_bisector(&left, &right, &source_line);
+    edge = new_edge(ctx, &source_line, &left, &right, left_site, right_site);
+    if (edge < 0) return -1;
+    edge_vertex(ctx, edge, &center);
+    if (!(node = new_boundary(ctx, left_node, &left, &right, left_site,
+                              right_site, edge))) return -1;
+    if (ctx->flags & VORONOI_DCEL) {
+        boundary_vertex(ctx, &node->bound, vertex, 1);
+        link_halfedges(ctx, edge, left_edge, left_site);
+        link_halfedges(ctx, right_edge, edge, right_site);
+    }
+    /* the sites of a converging arc and its neighbours are in clockwise 
+       order */
+    if (ctx->flags & VORONOI_TRIANGLES) {
+        int corners[3] = {left_site, right_site, mid_site};
+        int sides[3] = {right_edge, left_edge, edge};
+        if (new_triangle(ctx, corners, sides) < 0) return -1;
+    }
 
 
     /*this conditional handles a very specific edge case where the two 
       boundaries that neighbour the boundaries of the circle event happen
       to be antisymmetric and involve the original points, in which case this
       would not form a new circle event*/
-    if (new_left && new_right && (point_equality(&new_left->left_point,
-         &new_right->right_point)) && (point_equality(&new_right->left_point,
-        rightp)) && (point_equality(&new_left->right_point, leftp))) return 0;
+    if (new_left && new_right &&
+        new_left->left_site == new_right->right_site &&
+        new_right->left_site == right_site &&
+        new_left->right_site == left_site) return 0;
     
 
     /* if the neighbouring left actually exists and that is not the 
        midpoint itself, then add a new circle event */
-    if (new_left && !point_equality(&new_left->left_point, midp)
-        && !point_equality(&new_left->right_point, rightp)) {
-        new_circle_event(events, new_left, rightp, LEFT_SIDE,
-                         CIRCLE_EVENT, sweep);
+    if (new_left && new_left->left_site != mid_site
+        && new_left->right_site != right_site &&
+        new_circle_event(ctx, left_node, new_left, &right, right_site,
+                         LEFT_SIDE)) {
+        return -1;
     }
 
      /* if the neighbouring right actually exists and that is not the 
        midpoint itself, then add a new circle event */
-    if (new_right && !point_equality(&new_right->right_point, midp)
-        && !point_equality(&new_right->left_point, leftp)) {
-        new_circle_event(events, new_right, leftp, RIGHT_SIDE,
-                         CIRCLE_EVENT, sweep);
+    if (new_right && new_right->right_site != mid_site
+        && new_right->left_site != left_site &&
+        new_circle_event(ctx, node, new_right, &left, left_site, RIGHT_SIDE)) {
+        return -1;
     }
 
     return 0;
 }
 
-void preprocess_beachline(pqueue_t* points, bst_t* beachline) {
-    double x1, y1, x2, y2, sweep;
+int preprocess_beachline(voronoi_ctx_t* ctx, event_t* sites) {
+    double x1, y1, x2, y2;
     line_t source_line;
-    segment_t *edge;
-    event_t* event;
-    void* arg;
+    beach_node_t* node;
+    int edge;
 
-    pqueue_pop(points, (void**) &event);
-    x1 = event->sweep_event.x;
-    y1 = event->sweep_event.y;
-    event_free(event);
+    x1 = sites[0].sweep_event.x;
+    y1 = sites[0].sweep_event.y;
 
-    pqueue_pop(points, (void**) &event);
-    x2 = event->sweep_event.x;
-    y2 = event->sweep_event.y; 
-    event_free(event);
+    x2 = sites[1].sweep_event.x;
+    y2 = sites[1].sweep_event.y; 
 
-    sweep = y2 - EPSILON;   
-    arg = DOUBLE2VOID(sweep);
+    STAT(ctx->stats.site_events += 2);
 
     point_t p1 = {x1, y1};
     point_t p2 = {x2, y2};
 
+    /* the order of the boundaries follows from the sweep order of the two
+       sites, so they are threaded in directly */
     compute_bisector(&p1, &p2, &source_line);
-    edge = segment_new(&source_line, &p1, &p2);
-     if (y1 == y2) {
-        bst_insert(beachline, new_boundary(x2, y2, x1, y1, INTERSECT),
-                   edge, arg);
-     } else {
-        bst_insert(beachline, new_boundary(x1, y1, x2, y2, INTERSECT), 
-                   edge, arg);
-        bst_insert(beachline, new_boundary(x2, y2, x1, y1, INTERSECT),
-                   edge, arg);
+    edge = new_edge(ctx, &source_line, &p1, &p2, sites[0].site, sites[1].site);
+    if (edge < 0) return -1;
+    if (y1 == y2) {
+        node = new_boundary(ctx, NULL, &p2, &p1, sites[1].site, sites[0].site,
+                            edge);
+    } else {
+        node = new_boundary(ctx, NULL, &p1, &p2, sites[0].site, sites[1].site,
+                            edge);
+        if (node) {
+            node = new_boundary(ctx, node, &p2, &p1, sites[1].site,
+                                sites[0].site, edge);
+        }
     }
+    return node ? 0 : -1;
 }
 
-void postprocess_beachline(bst_t* beachline, bst_t* voronoi, double sweep) {
-    boundary_t* bound;
-    segment_t* segment;
-    void* arg = DOUBLE2VOID(sweep);
+/**
+ * @brief reads the monotonic clock
+ * 
+ * @return double seconds since an arbitrary fixed point
+ */
+double wall_seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief qsort comparator ordering site events the way the event queue 
+ *        would pop them
+ * 
+ * @param s1 
+ * @param s2 
+ * @return int negative if s1 comes first, positive otherwise
+ */
+int site_compare(const void* s1, const void* s2) {
+    return -event_compare((void*) s1, (void*) s2);
+}
+
+/**
+ * @brief pops the next event of the sweep, which is either the next of the
+ *        sorted sites or the top of the circle event queue, whichever 
+ *        comes first
+ * 
+ * @param sites site events sorted in sweep order
+ * @param nsites number of sites
+ * @param cursor index of the next unprocessed site, advanced if a site is 
+ *               popped
+ * @param circles priority queue of circle events
+ * @return event_t* the next event, NULL once both are exhausted
+ */
+event_t* next_event(event_t* sites, int nsites, int* cursor,
+                    pqueue_t* circles) {
+    event_t* circle = NULL;
+
+    pqueue_peek(circles, (void**) &circle);
+    if (*cursor < nsites &&
+        (circle == NULL || event_compare(&sites[*cursor], circle) == 1)) {
+        return &sites[(*cursor)++];
+    }
+    if (circle != NULL) pqueue_pop(circles, (void**) &circle);
+    return circle;
+}
 
-    while(!bst_rootkey(beachline, (void**) &bound)) {
-        bst_delete(beachline, bound, (void**) &segment, arg);
-        bst_insert(voronoi, segment, NULL, NULL);
+/**
+ * @brief prepares one cell per input point, none of which has edges yet
+ * 
+ * @param ctx state of the sweep
+ * @param npoints number of input points
+ * @return int 0 on success, -1 if allocation failed
+ */
+int init_cells(voronoi_ctx_t* ctx, int npoints) {
+    voronoi_cell_t* cells;
+    if (npoints > ctx->cells_size) {
+        if (!(cells = realloc(ctx->cells, npoints * sizeof(voronoi_cell_t)))) {
+            return -1;
+        }
+        ctx->cells = cells;
+        ctx->cells_size = npoints;
     }
+    for (int i = 0; i < npoints; i++) ctx->cells[i].halfedge = -1;
+    ctx->ncells = npoints;
+    return 0;
+}
 
+/**
+ * @brief allocates a new computation context, which can be reused for any
+ *        number of computations
+ * 
+ * @param flags VORONOI_DCEL to also build the topology of every diagram,
+ *              VORONOI_TRIANGLES its delaunay triangles, optionally along
+ *              with VORONOI_NEIGHBOURS, 0 for neither
+ * @return voronoi_ctx_t* the context, NULL if allocation failed
+ */
+voronoi_ctx_t* voronoi_ctx_new(int flags) {
+    voronoi_ctx_t* ctx;
+    if (!(ctx = calloc(1, sizeof(voronoi_ctx_t)))) return NULL;
+    ctx->flags = flags;
+    if (!(ctx->beachline = beachline_new()) ||
+        !(ctx->events = pqueue_new_indexed(*event_compare, *event_slot)) ||
+        !(ctx->event_pool = pool_new(sizeof(event_t)))) {
+        voronoi_ctx_free(ctx);
+        return NULL;
+    }
+    return ctx;
 }
 
-bst_t* compute_voronoi(pqueue_t* points) {
-    event_t* event;
-    bst_t *beachline = bst_new(*beachline_compare, *boundary_free);
-    bst_t *voronoi = bst_new(*segment_compare, *segment_free);
-    double sweep;
+/**
+ * @brief sets the rectangle to which the following computations with a 
+ *        context clip their edges, each one being clipped as soon as it is
+ *        final, so that none is left unbounded, edges lying outside of the
+ *        rectangle are labelled SEG_OUTSIDE and all others become segments
+ *        running with the first site of their dual on their left
+ * 
+ * @param ctx 
+ * @param box rectangle to clip to, NULL to stop clipping
+ */
+void voronoi_ctx_clip(voronoi_ctx_t* ctx, box_t* box) {
+    ctx->clip = box != NULL;
+    if (box) ctx->box = *box;
+}
+
+/**
+ * @brief drops the state and result of the previous computation, all 
+ *        capacity is kept for the next one
+ * 
+ * @param ctx 
+ */
+void voronoi_ctx_reset(voronoi_ctx_t* ctx) {
+    beachline_clear(ctx->beachline);
+    pqueue_clear(ctx->events);
+    pool_reset(ctx->event_pool);
+    ctx->nedges = 0;
+    ctx->nvertices = 0;
+    ctx->ncells = 0;
+    ctx->ntriangles = 0;
+    ctx->next_tag = 0;
+    ctx->emit = NULL;
+    ctx->nemitted = 0;
+    ctx->sink_failed = 0;
+    ctx->nfree = 0;
+    ctx->timing.build = 0;
+    ctx->timing.sweep = 0;
+    ctx->stats = (voronoi_stats_t) {0};
+}
+
+void voronoi_ctx_free(voronoi_ctx_t* ctx) {
+    if (ctx->beachline) beachline_free(ctx->beachline);
+    if (ctx->events) {
+        pqueue_clear(ctx->events);
+        pqueue_free(ctx->events);
+    }
+    if (ctx->event_pool) pool_free(ctx->event_pool);
+    free(ctx->edges);
+    free(ctx->sites);
+    free(ctx->vertices);
+    free(ctx->halfedges);
+    free(ctx->cells);
+    free(ctx->triangles);
+    free(ctx->neighbours);
+    free(ctx->edge_corners);
+    free(ctx->polygon_vertices);
+    free(ctx->polygon_offsets);
+    for (int i = 0; i < ctx->slabs_size; i++) {
+        if (ctx->slabs[i]) voronoi_ctx_free(ctx->slabs[i]);
+    }
+    free(ctx->slabs);
+    free(ctx->refs);
+    free(ctx->sorted);
+    free(ctx->duals);
+    free(ctx->free_edges);
+    free(ctx);
+}
+
+/**
+ * @brief records a processed event, along with the time it took
+ * 
+ * @param ctx state of the sweep
+ * @param label SITE_EVENT or CIRCLE_EVENT
+ * @param start time processing the event started at
+ */
+void count_event(voronoi_ctx_t* ctx, char label, double start) {
+    if (label == SITE_EVENT) {
+        ctx->stats.site_events++;
+        ctx->stats.site_seconds += wall_seconds() - start;
+    } else {
+        ctx->stats.circle_events++;
+        ctx->stats.circle_seconds += wall_seconds() - start;
+    }
+}
+
+/**
+ * @brief computes the voronoi diagram of a set of points, the sites are 
+ *        sorted once up front so the event queue only ever holds circle 
+ *        events, a point given more than once is a site at its first 
+ *        occurrence only and the others get no edges
+ * 
+ * @param ctx computation context, its previous result is discarded
+ * @param points array of input points
+ * @param npoints number of points
+ * @param edgesp pointer to which the array of voronoi edges is written, 
+ *               the array is owned by the context and valid until it is 
+ *               reset, reused or freed
+ * @return int number of edges, -1 if allocation failed
+ */
+int compute_voronoi(voronoi_ctx_t* ctx, point_t* points, int npoints,
+                    segment_t** edgesp) {
+    event_t *sites, *event;
+    int status, nsites, cursor = 2;
+    double start;
+    STAT(double event_start);
+
+    voronoi_ctx_reset(ctx);
+    *edgesp = ctx->edges;
+    ctx->points = points;
+    if ((ctx->flags & VORONOI_DCEL) && init_cells(ctx, npoints)) return -1;
+    if (npoints < 2) return 0;
+    start = wall_seconds();
+    if (npoints > ctx->sites_size) {
+        if (!(sites = realloc(ctx->sites, npoints * sizeof(event_t)))) {
+            return -1;
+        }
+        ctx->sites = sites;
+        ctx->sites_size = npoints;
+    }
+    sites = ctx->sites;
+    for (int i = 0; i < npoints; i++) {
+        init_event(&sites[i], ctx->next_tag++, SITE_EVENT, points[i].x,
+                   points[i].y, -1, -1, -1);
+        sites[i].site = i;
+    }
+    qsort(sites, npoints, sizeof(event_t), site_compare);
+    /* the copies of a point follow its first occurrence, whose tag is the
+       lowest */
+    nsites = 1;
+    for (int i = 1; i < npoints; i++) {
+        if (sites[i].sweep_event.x != sites[nsites - 1].sweep_event.x ||
+            sites[i].sweep_event.y != sites[nsites - 1].sweep_event.y) {
+            sites[nsites++] = sites[i];
+        }
+    }
+    ctx->timing.build = wall_seconds() - start;
+    if (nsites < 2) return 0;
+    start = wall_seconds();
 
-    preprocess_beachline(points, beachline);
+    if (preprocess_beachline(ctx, sites)) {
+        voronoi_ctx_reset(ctx);
+        return -1;
+    }
 
-     while (pqueue_size(points) > 0) {
+    while ((event = next_event(sites, nsites, &cursor, ctx->events))) {
+        STAT(event_start = wall_seconds());
 
-        pqueue_pop(points, (void**) &event);
+        if (event->label == SITE_EVENT) {
+            status = process_site(ctx, &event->sweep_event, event->site);
+            STAT(count_event(ctx, SITE_EVENT, event_start));
+        } else {
+            status = process_circle_event(ctx, event);
+            STAT(count_event(ctx, CIRCLE_EVENT, event_start));
+            event_free(ctx->event_pool, event);
+        }
+        /* the beachline is left half updated, so the partial diagram is 
+           dropped along with it */
+        if (status) {
+            voronoi_ctx_reset(ctx);
+            return -1;
+        }
+    }
+    if (ctx->clip) clip_unbounded(ctx);
 
-        sweep = event->sweep_event.y;
+    ctx->timing.sweep = wall_seconds() - start;
+    *edgesp = ctx->edges;
+    return ctx->nedges;
+}
+
+/**
+ * @brief pulls the next site of a stream into a site event
+ * 
+ * @param ctx state of the sweep
+ * @param next_site source of the sites
+ * @param source 
+ * @param site event to be initialized, its index is the number of sites 
+ *             read before it
+ * @param prev previously read site, NULL for the first one
+ * @return int 1 if a site was read, 0 at the end of the stream, -1 if 
+ *         reading failed or the site comes before prev in sweep order
+ */
+int read_site(voronoi_ctx_t* ctx, int (*next_site)(void*, point_t*),
+              void* source, event_t* site, event_t* prev) {
+    point_t point;
+    int status, index = prev ? prev->site + 1 : 0;
+
+    /* the copies of a point follow it in sweep order and are skipped, as
+       compute_voronoi does */
+    do {
+        if ((status = next_site(source, &point)) <= 0) return status;
+    } while (prev && point.x == prev->sweep_event.x &&
+             point.y == prev->sweep_event.y);
+    /* compute_voronoi tags the sites before any circle event, so a site 
+       goes before a circle event at the same point, the same tags keep 
+       cocircular sites in the same order here */
+    init_event(site, INT_MIN + index, SITE_EVENT, point.x, point.y, -1, -1,
+               -1);
+    site->site = index;
+    if (prev && event_compare(prev, site) != 1) return -1;
+    return 1;
+}
+
+/**
+ * @brief computes the voronoi diagram of a stream of points without ever 
+ *        holding all of them, the sites are pulled one at a time as the 
+ *        sweep reaches them and every edge is handed to a sink once both 
+ *        its ends are fixed, so memory stays proportional to the beachline
+ *        and the pending events (plus the unbounded edges, which are only 
+ *        final at the end) rather than to the number of points
+ * 
+ * @param ctx computation context created without VORONOI_DCEL and 
+ *            VORONOI_TRIANGLES, its previous result is discarded
+ * @param next_site writes the next point to its second argument and 
+ *                  returns 1, or returns 0 once the points run out and -1 
+ *                  on failure, the points must come in sweep order, i.e.
+ *                  by decreasing y and then by decreasing x
+ * @param source first argument of next_site
+ * @param emit receives every edge along with the two sites of its dual, 
+ *             which are only valid during the call, returns 0 on success 
+ *             and anything else to fail the computation
+ * @param sink first argument of emit
+ * @return int number of edges emitted, -1 on failure
+ */
+int compute_voronoi_stream(voronoi_ctx_t* ctx,
+                           int (*next_site)(void*, point_t*), void* source,
+                           int (*emit)(void*, segment_t*, point_t*, point_t*),
+                           void* sink) {
+    event_t sites[2], next, *event;
+    point_t* duals;
+    int status, failed, cursor;
+    STAT(double event_start);
+
+    voronoi_ctx_reset(ctx);
+    if (ctx->flags & (VORONOI_DCEL | VORONOI_TRIANGLES)) return -1;
+    /* the edge slots may have grown without their duals in an earlier
+       computation */
+    if (ctx->edges_size) {
+        if (!(duals = realloc(ctx->duals,
+                              2 * ctx->edges_size * sizeof(point_t)))) {
+            return -1;
+        }
+        ctx->duals = duals;
+    }
+    ctx->emit = emit;
+    ctx->sink = sink;
+
+    if ((status = read_site(ctx, next_site, source, &sites[0], NULL)) <= 0 ||
+        (status = read_site(ctx, next_site, source, &sites[1], &sites[0]))
+        <= 0) {
+        return status;
+    }
+    if (preprocess_beachline(ctx, sites)) {
+        voronoi_ctx_reset(ctx);
+        return -1;
+    }
+    status = read_site(ctx, next_site, source, &next, &sites[1]);
+
+    /* the site queue is a window of at most one site, refilled from the 
+       stream whenever its site is popped */
+    while (status >= 0) {
+        cursor = 0;
+        if (!(event = next_event(&next, status, &cursor, ctx->events))) break;
+
+        STAT(event_start = wall_seconds());
 
         if (event->label == SITE_EVENT) {
-            process_site(beachline, points, voronoi, &event->sweep_event, sweep);
+            failed = process_site(ctx, &next.sweep_event, next.site);
+            STAT(count_event(ctx, SITE_EVENT, event_start));
+            sites[0] = next;
+            status = read_site(ctx, next_site, source, &next, &sites[0]);
         } else {
-            process_circle_event(beachline, points, voronoi, event, sweep + EPSILON);
+            failed = process_circle_event(ctx, event);
+            STAT(count_event(ctx, CIRCLE_EVENT, event_start));
+            event_free(ctx->event_pool, event);
         }
-        event_free(event);
+        if (failed) status = -1;
+    }
+    if (status < 0) {
+        voronoi_ctx_reset(ctx);
+        return -1;
     }
 
-    postprocess_beachline(beachline, voronoi, sweep);
-    free(beachline);
+    /* whatever was not emitted yet runs off to infinity */
+    if (ctx->clip) clip_unbounded(ctx);
+    for (int i = 0; i < ctx->nedges; i++) {
+        if (ctx->edges[i].label == SEG_EMITTED ||
+            ctx->edges[i].label == SEG_OUTSIDE) continue;
+        if (emit(sink, &ctx->edges[i], &ctx->duals[2 * i],
+                 &ctx->duals[2 * i + 1])) ctx->sink_failed = 1;
+        ctx->nemitted++;
+    }
+    return ctx->sink_failed ? -1 : ctx->nemitted;
+}
+
+void voronoi_job_run(void* jobs, int i) {
+    voronoi_job_t* job = &((voronoi_job_t*) jobs)[i];
+    job->nedges = compute_voronoi(job->ctx, job->points, job->npoints,
+                                  &job->edges);
+}
 
-    return voronoi; 
+/**
+ * @brief computes a batch of independent diagrams in parallel, each job 
+ *        needs a context of its own since contexts are not shared between
+ *        threads
+ * 
+ * @param jobs diagrams to compute, their edges and nedges are written as
+ *             compute_voronoi would
+ * @param njobs number of jobs
+ * @param nthreads maximum number of threads, 0 for one per processor
+ * @return int 0 on success, -1 if any of the computations failed
+ */
+int compute_voronoi_many(voronoi_job_t* jobs, int njobs, int nthreads) {
+    parallel_for(njobs, nthreads, voronoi_job_run, jobs);
+    for (int i = 0; i < njobs; i++) {
+        if (jobs[i].nedges < 0) return -1;
+    }
+    return 0;
 }
 
+/************/
+/* PARALLEL */
+/************/
+
+/**
+ * @brief qsort comparator ordering sites by x, then by y
+ * 
+ * @param s1 
+ * @param s2 
+ * @return int 
+ */
+int site_ref_compare(const void* s1, const void* s2) {
+    point_t* p1 = &((site_ref_t*) s1)->point;
+    point_t* p2 = &((site_ref_t*) s2)->point;
+    if (p1->x != p2->x) return p1->x < p2->x ? -1 : 1;
+    if (p1->y != p2->y) return p1->y < p2->y ? -1 : 1;
+    return ((site_ref_t*) s1)->index - ((site_ref_t*) s2)->index;
+}
+
+int double_compare(const void* d1, const void* d2) {
+    double a = *(double*) d1, b = *(double*) d2;
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief returns the slab of an x-value, sites with equal x always share a
+ *        slab so that every slab lies strictly to the left of the next
+ * 
+ * @param x 
+ * @param splitters the smallest x-value of every slab but the first
+ * @param nsplitters 
+ * @return int 
+ */
+int slab_of(double x, double* splitters, int nsplitters) {
+    int lo = 0, hi = nsplitters, mid;
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (splitters[mid] <= x) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief distributes the points into slabs of about equal size, the 
+ *        splitters between slabs are picked from an evenly spaced sample
+ * 
+ * @param ctx context of the computation
+ * @param points input points
+ * @param npoints number of points
+ * @param nslabs number of slabs
+ * @param bounds array of nslabs + 1 entries to which the ranges of the 
+ *               slabs in ctx->refs are written
+ * @return int 0 on success, -1 if allocation failed
+ */
+int bucket_sites(voronoi_ctx_t* ctx, point_t* points, int npoints,
+                 int nslabs, int* bounds) {
+    int nsample = npoints < 64 * nslabs ? npoints : 64 * nslabs;
+    double* sample;
+    double* splitters;
+    int* fill;
+
+    if (!(sample = malloc((nsample + nslabs) * sizeof(double)))) return -1;
+    splitters = sample + nsample;
+    for (int i = 0; i < nsample; i++) {
+        sample[i] = points[(long) i * npoints / nsample].x;
+    }
+    qsort(sample, nsample, sizeof(double), double_compare);
+    for (int i = 1; i < nslabs; i++) {
+        splitters[i - 1] = sample[(long) i * nsample / nslabs];
+    }
+
+    fill = bounds;
+    memset(bounds, 0, (nslabs + 1) * sizeof(int));
+    for (int i = 0; i < npoints; i++) {
+        bounds[slab_of(points[i].x, splitters, nslabs - 1) + 1]++;
+    }
+    for (int i = 0; i < nslabs; i++) bounds[i + 1] += bounds[i];
+    /* filling a slab moves its bound to the start of the next one */
+    for (int i = 0; i < npoints; i++) {
+        int slab = slab_of(points[i].x, splitters, nslabs - 1);
+        point_copy(&points[i], &ctx->refs[fill[slab]].point);
+        ctx->refs[fill[slab]++].index = i;
+    }
+    for (int i = nslabs; i > 0; i--) bounds[i] = bounds[i - 1];
+    bounds[0] = 0;
+    free(sample);
+    return 0;
+}
+
+/**
+ * @brief sorts the sites of a slab and keeps the first occurrence of every
+ *        point given more than once, the merge needs distinct sites
+ * 
+ * @param b batch of the computation
+ * @param i index of the slab
+ */
+void slab_sort(void* b, int i) {
+    slab_batch_t* batch = (slab_batch_t*) b;
+    site_ref_t* refs = batch->ctx->refs;
+    int lo = batch->bounds[i], hi = batch->bounds[i + 1], n = lo;
+
+    qsort(&refs[lo], hi - lo, sizeof(site_ref_t), site_ref_compare);
+    for (int k = lo; k < hi; k++) {
+        if (n == lo || !point_equality(&refs[k].point, &refs[n - 1].point)) {
+            refs[n++] = refs[k];
+        }
+    }
+    batch->sizes[i] = n - lo;
+}
+
+/**
+ * @brief moves the distinct sites of every slab right after those of the
+ *        previous one
+ * 
+ * @param batch 
+ * @param nslabs number of slabs
+ */
+void pack_slabs(slab_batch_t* batch, int nslabs) {
+    site_ref_t* refs = batch->ctx->refs;
+    int n = 0;
+
+    for (int i = 0; i < nslabs; i++) {
+        memmove(&refs[n], &refs[batch->bounds[i]],
+                batch->sizes[i] * sizeof(site_ref_t));
+        batch->bounds[i] = n;
+        n += batch->sizes[i];
+    }
+    batch->bounds[nslabs] = n;
+}
+
+/**
+ * @brief computes the diagram of a slab
+ * 
+ * @param b batch of the computation
+ * @param i index of the slab
+ */
+void slab_run(void* b, int i) {
+    slab_batch_t* batch = (slab_batch_t*) b;
+    voronoi_ctx_t* ctx = batch->ctx;
+    int lo = batch->bounds[i], hi = batch->bounds[i + 1];
+    voronoi_dcel_t dcel;
+    segment_t* edges;
+
+    for (int k = lo; k < hi; k++) {
+        point_copy(&ctx->refs[k].point, &ctx->sorted[k]);
+    }
+    batch->failed[i] = 
+        compute_voronoi(ctx->slabs[i], &ctx->sorted[lo], hi - lo, &edges) < 0
+        || voronoi_dcel(ctx->slabs[i], &dcel)
+        || part_from_dcel(&batch->parts[i], &dcel, lo, hi);
+}
+
+/**
+ * @brief merges a pair of neighbouring parts, the merged diagram takes the
+ *        place of the left one
+ * 
+ * @param b batch of the computation
+ * @param i index of the pair
+ */
+void slab_merge(void* b, int i) {
+    slab_batch_t* batch = (slab_batch_t*) b;
+    part_t merged;
+    part_t* left = &batch->parts[2 * i * batch->stride];
+    part_t* right = left + batch->stride;
+
+    if (batch->failed[2 * i * batch->stride] ||
+        batch->failed[(2 * i + 1) * batch->stride]) {
+        batch->failed[2 * i * batch->stride] = 1;
+        return;
+    }
+    /* slabs of sites sharing an x-value can end up empty */
+    if (right->lo == right->hi) return;
+    if (left->lo == left->hi) {
+        part_free(left);
+        *left = *right;
+        right->vertices = NULL;
+        right->edges = NULL;
+        return;
+    }
+    if (part_merge(&merged, left, right, batch->ctx->sorted)) {
+        batch->failed[2 * i * batch->stride] = 1;
+        return;
+    }
+    part_free(left);
+    part_free(right);
+    *left = merged;
+}
+
+/**
+ * @brief prepares the buffers of a parallel computation
+ * 
+ * @param ctx 
+ * @param npoints number of points
+ * @param nslabs number of slabs
+ * @return int 0 on success, -1 if allocation failed
+ */
+int reserve_slabs(voronoi_ctx_t* ctx, int npoints, int nslabs) {
+    site_ref_t* refs;
+    point_t* sorted;
+    voronoi_ctx_t** slabs;
+
+    if (npoints > ctx->sorted_size) {
+        if (!(refs = realloc(ctx->refs, npoints * sizeof(site_ref_t)))) {
+            return -1;
+        }
+        ctx->refs = refs;
+        if (!(sorted = realloc(ctx->sorted, npoints * sizeof(point_t)))) {
+            return -1;
+        }
+        ctx->sorted = sorted;
+        ctx->sorted_size = npoints;
+    }
+    if (nslabs > ctx->slabs_size) {
+        if (!(slabs = realloc(ctx->slabs, nslabs * sizeof(voronoi_ctx_t*)))) {
+            return -1;
+        }
+        ctx->slabs = slabs;
+        for (; ctx->slabs_size < nslabs; ctx->slabs_size++) {
+            ctx->slabs[ctx->slabs_size] = NULL;
+        }
+    }
+    for (int i = 0; i < nslabs; i++) {
+        if (!ctx->slabs[i] && !(ctx->slabs[i] = voronoi_ctx_new(VORONOI_DCEL))) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief writes a merged diagram as the edges of the computation
+ * 
+ * @param ctx 
+ * @param part diagram of all sites
+ * @return int 0 on success, -1 if allocation failed
+ */
+int emit_part(voronoi_ctx_t* ctx, part_t* part) {
+    line_t source_line;
+    part_edge_t* e;
+    point_t *p0, *p1;
+    int edge;
+
+    for (int i = 0; i < part->nedges; i++) {
+        e = &part->edges[i];
+        p0 = &ctx->sorted[e->site[0]];
+        p1 = &ctx->sorted[e->site[1]];
+        compute_bisector(p0, p1, &source_line);
+        if ((edge = new_edge(ctx, &source_line, p0, p1,
+                             ctx->refs[e->site[0]].index,
+                             ctx->refs[e->site[1]].index)) < 0) return -1;
+        for (int k = 0; k < 2; k++) {
+            if (e->v[k] >= 0) {
+                segment_transform(&ctx->edges[edge],
+                                  &part->vertices[e->v[k]]);
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief adds the counters of the last computation of a slab to those of 
+ *        the context it belongs to
+ * 
+ * @param ctx 
+ * @param slab 
+ */
+void add_stats(voronoi_ctx_t* ctx, voronoi_ctx_t* slab) {
+    voronoi_stats_t* total = &ctx->stats;
+    voronoi_stats_t stats;
+
+    voronoi_stats(slab, &stats);
+    total->site_events += stats.site_events;
+    total->circle_events += stats.circle_events;
+    total->stale_circle_events += stats.stale_circle_events;
+    total->breakpoint_tests += stats.breakpoint_tests;
+    if (total->searches + stats.searches) {
+        total->mean_depth = (total->mean_depth * total->searches +
+                             stats.mean_depth * stats.searches) /
+                            (total->searches + stats.searches);
+    }
+    total->searches += stats.searches;
+    if (stats.max_depth > total->max_depth) {
+        total->max_depth = stats.max_depth;
+    }
+    if (stats.max_beachline > total->max_beachline) {
+        total->max_beachline = stats.max_beachline;
+    }
+    if (stats.max_events > total->max_events) {
+        total->max_events = stats.max_events;
+    }
+    total->allocations += stats.allocations;
+    total->site_seconds += stats.site_seconds;
+    total->circle_seconds += stats.circle_seconds;
+}
+
+/**
+ * @brief computes the voronoi diagram of a set of points on several 
+ *        threads, the points are split into vertical slabs whose diagrams
+ *        are computed in parallel and then merged pairwise, each round of
+ *        merges running in parallel as well, the merge only produces the 
+ *        edges, so a context that also needs the topology, the triangles
+ *        or clipping is computed on a single thread
+ * 
+ * @param ctx computation context, its previous result is discarded
+ * @param points array of input points
+ * @param npoints number of points
+ * @param nthreads number of threads, 0 for one per processor
+ * @param edgesp pointer to which the array of voronoi edges is written, 
+ *               as compute_voronoi would
+ * @return int number of edges, -1 on failure, inputs too small to be worth
+ *         splitting, contexts built with VORONOI_DCEL or 
+ *         VORONOI_TRIANGLES and contexts that clip are computed by 
+ *         compute_voronoi, which the slabs counter of the statistics 
+ *         tells, the edges are those of compute_voronoi except that a 
+ *         point given more than once only gets the edges of its first 
+ *         occurrence, and that where four or more cocircular sites 
+ *         straddle a slab boundary the zero-length edges between them may
+ *         join other pairs of them
+ */
+int compute_voronoi_parallel(voronoi_ctx_t* ctx, point_t* points, int npoints,
+                             int nthreads, segment_t** edgesp) {
+    slab_batch_t batch;
+    int nslabs, nparts, status = -1;
+
+    if (nthreads <= 0) nthreads = parallel_threads();
+    nslabs = nthreads;
+    if (npoints < nslabs * PARALLEL_MIN_SITES) {
+        nslabs = npoints / PARALLEL_MIN_SITES;
+    }
+    if (nslabs < 2 || (ctx->flags & (VORONOI_DCEL | VORONOI_TRIANGLES)) ||
+        ctx->clip) {
+        return compute_voronoi(ctx, points, npoints, edgesp);
+    }
+
+    voronoi_ctx_reset(ctx);
+    *edgesp = ctx->edges;
+    batch.ctx = ctx;
+    batch.bounds = malloc((nslabs + 1) * sizeof(int));
+    batch.sizes = malloc(nslabs * sizeof(int));
+    batch.parts = calloc(nslabs, sizeof(part_t));
+    batch.failed = calloc(nslabs, 1);
+    if (!batch.bounds || !batch.sizes || !batch.parts || !batch.failed ||
+        reserve_slabs(ctx, npoints, nslabs) ||
+        bucket_sites(ctx, points, npoints, nslabs, batch.bounds)) goto done;
+
+    parallel_for(nslabs, nthreads, slab_sort, &batch);
+    pack_slabs(&batch, nslabs);
+    parallel_for(nslabs, nthreads, slab_run, &batch);
+    for (batch.stride = 1; batch.stride < nslabs; batch.stride *= 2) {
+        nparts = (nslabs + batch.stride - 1) / batch.stride;
+        parallel_for(nparts / 2, nthreads, slab_merge, &batch);
+    }
+    if (!batch.failed[0]) status = emit_part(ctx, &batch.parts[0]);
+    STAT(for (int i = 0; i < nslabs; i++) {
+        add_stats(ctx, ctx->slabs[i]);
+    })
+    STAT(ctx->stats.slabs = nslabs);
+
+done:
+    if (batch.parts) {
+        for (int i = 0; i < nslabs; i++) part_free(&batch.parts[i]);
+    }
+    free(batch.bounds);
+    free(batch.sizes);
+    free(batch.parts);
+    free(batch.failed);
+    if (status) {
+        voronoi_ctx_reset(ctx);
+        return -1;
+    }
+    *edgesp = ctx->edges;
+    return ctx->nedges;
+}
+
+/**
+ * @brief gives access to the topology of the last diagram computed with a
+ *        context, the arrays are owned by the context and valid until it 
+ *        is reset, reused or freed
+ * 
+ * @param ctx context created with VORONOI_DCEL
+ * @param dcel struct to which the topology is written
+ * @return int 0 on success, -1 if the context does not build topologies
+ */
+int voronoi_dcel(voronoi_ctx_t* ctx, voronoi_dcel_t* dcel) {
+    if (!(ctx->flags & VORONOI_DCEL)) return -1;
+    dcel->vertices = ctx->vertices;
+    dcel->nvertices = ctx->nvertices;
+    dcel->halfedges = ctx->halfedges;
+    dcel->nhalfedges = 2 * ctx->nedges;
+    dcel->cells = ctx->cells;
+    dcel->ncells = ctx->ncells;
+    return 0;
+}
+
+/**
+ * @brief gives access to the delaunay triangles of the last diagram 
+ *        computed with a context, the arrays are owned by the context and 
+ *        valid until it is reset, reused or freed
+ * 
+ * @param ctx context created with VORONOI_TRIANGLES
+ * @param triangulation struct to which the triangles are written
+ * @return int 0 on success, -1 if the context does not build triangles
+ */
+int voronoi_triangulation(voronoi_ctx_t* ctx,
+                          voronoi_triangulation_t* triangulation) {
+    if (!(ctx->flags & VORONOI_TRIANGLES)) return -1;
+    triangulation->triangles = ctx->triangles;
+    triangulation->ntriangles = ctx->ntriangles;
+    triangulation->neighbours = ctx->flags & VORONOI_NEIGHBOURS ?
+                                ctx->neighbours : NULL;
+    return 0;
+}
+
+/**
+ * @brief finds the part of the edge of a half-edge that lies in the clip 
+ *        rectangle, running along the half-edge
+ * 
+ * @param ctx context that clips, whose last diagram was not streamed
+ * @param half index of the half-edge
+ * @param last end of the part of the previous half-edge of the cell, NULL
+ *             if unknown
+ * @param ends start and end of the part
+ * @return int 0 on success, -1 if the edge misses the rectangle or has 
+ *         zero length
+ */
+int halfedge_clipped(voronoi_ctx_t* ctx, int half, point_t* last,
+                     point_t** ends) {
+    voronoi_halfedge_t* h = &ctx->halfedges[half];
+    segment_t* seg = &ctx->edges[half / 2];
+    point_t *p1 = SEG_POINT1(seg), *p2 = SEG_POINT2(seg), *v = NULL;
+    int reversed = seg->dual.site1 != h->cell;
+
+    if (seg->label != SEG_SEG || point_equality(p1, p2)) return -1;
+    /* clipping orients an edge by its sites, which rounding overrides for
+       the tiny edges between cocircular sites, so the part starts at the
+       vertex the half-edge does, which ends the previous part unless the
+       cell left the rectangle in between */
+    if (last && (point_equality(p1, last) || point_equality(p2, last))) {
+        v = last;
+    } else if (h->origin >= 0) {
+        v = &ctx->vertices[h->origin];
+    }
+    if (v && point_equality(p1, v)) reversed = 0;
+    else if (v && point_equality(p2, v)) reversed = 1;
+    ends[reversed] = p1;
+    ends[!reversed] = p2;
+    return 0;
+}
+
+/**
+ * @brief position of a point on the boundary of a rectangle, the distance
+ *        travelled counterclockwise from its lower left corner to reach it
+ * 
+ * @param box rectangle
+ * @param p point on one of its sides
+ * @return double 
+ */
+double box_position(box_t* box, point_t* p) {
+    double w = box->xmax - box->xmin, h = box->ymax - box->ymin;
+
+    if (p->y == box->ymin && p->x < box->xmax) return p->x - box->xmin;
+    if (p->x == box->xmax && p->y < box->ymax) return w + p->y - box->ymin;
+    if (p->y == box->ymax && p->x > box->xmin) {
+        return w + h + box->xmax - p->x;
+    }
+    return 2 * w + h + box->ymax - p->y;
+}
+
+/**
+ * @brief appends a vertex to a polygon unless it repeats the last one
+ * 
+ * @param polygon 
+ * @param n number of vertices of polygon
+ * @param p vertex appended
+ * @return int the new number of vertices
+ */
+int polygon_push(point_t* polygon, int n, point_t* p) {
+    if (n && point_equality(&polygon[n - 1], p)) return n;
+    point_copy(p, &polygon[n]);
+    return n + 1;
+}
+
+/**
+ * @brief appends the corners of a rectangle passed going counterclockwise
+ *        along its boundary from one point of it to another, none if 
+ *        rounding put the second just behind the first, which would pass
+ *        all four
+ * 
+ * @param box rectangle
+ * @param from point on its boundary
+ * @param to point on its boundary
+ * @param polygon polygon appended to
+ * @param n number of vertices of polygon
+ * @return int the new number of vertices
+ */
+int polygon_corners(box_t* box, point_t* from, point_t* to, point_t* polygon,
+                    int n) {
+    double w = box->xmax - box->xmin, h = box->ymax - box->ymin;
+    point_t corners[4] = {{box->xmin, box->ymin}, {box->xmax, box->ymin},
+                          {box->xmax, box->ymax}, {box->xmin, box->ymax}};
+    double positions[4] = {0, w, w + h, 2 * w + h}, perimeter = 2 * (w + h);
+    double start = box_position(box, from), gap, offset;
+    int first, count;
+
+    gap = box_position(box, to) - start;
+    if (gap < 0) gap += perimeter;
+    for (first = 0; first < 4 && positions[first] <= start; first++);
+    for (count = 0; count < 4; count++) {
+        offset = positions[(first + count) % 4] - start;
+        if (offset <= 0) offset += perimeter;
+        if (offset >= gap) break;
+    }
+    if (count == 4) return n;
+    for (int i = 0; i < count; i++) {
+        n = polygon_push(polygon, n, &corners[(first + i) % 4]);
+    }
+    return n;
+}
+
+/**
+ * @brief appends the clipped edges of a run of half-edges of a cell to its
+ *        polygon, following next until the boundary of the cell is open or
+ *        reaches a given half-edge, where the cell leaves the rectangle 
+ *        between two edges it runs along the rectangle instead
+ * 
+ * @param ctx context that clips, whose last diagram was not streamed
+ * @param half first half-edge of the run, set to where it stopped, -1 if
+ *             the boundary is open
+ * @param stop half-edge before which the run stops
+ * @param polygon polygon appended to
+ * @param n number of vertices of polygon
+ * @param first start of the first edge in the rectangle, NULL if there is
+ *              none yet, set to it otherwise
+ * @param last end of the last edge in the rectangle, updated as edges are
+ *             appended
+ * @return int the new number of vertices
+ */
+int polygon_run(voronoi_ctx_t* ctx, int* half, int stop, point_t* polygon,
+                int n, point_t** first, point_t** last) {
+    point_t* ends[2];
+    int h = *half;
+
+    for (int i = 0; i < 2 * ctx->nedges && h >= 0; i++) {
+        if (!halfedge_clipped(ctx, h, *last, ends)) {
+            if (!*first) *first = ends[0];
+            else if (!point_equality(*last, ends[0])) {
+                n = polygon_corners(&ctx->box, *last, ends[0], polygon, n);
+            }
+            n = polygon_push(polygon, n, ends[0]);
+            n = polygon_push(polygon, n, ends[1]);
+            *last = ends[1];
+        }
+        if ((h = ctx->halfedges[h].next) == stop) break;
+    }
+    *half = h;
+    return n;
+}
+
+/**
+ * @brief builds the cells of the last diagram computed with a context as
+ *        polygons clipped to its clip rectangle, out of its clipped edges 
+ *        taken in the order its topology runs around every cell, joined 
+ *        along the rectangle where the cell leaves it. A cell without edges
+ *        in the rectangle misses it, unless it holds all of it, so cells of
+ *        sites outside of the rectangle may be empty. The arrays are owned 
+ *        by the context and valid until the next call, or until it is 
+ *        freed
+ * 
+ * @param ctx context created with VORONOI_DCEL that clips, whose last 
+ *            diagram was not streamed
+ * @param points the input points of that diagram
+ * @param npoints number of input points
+ * @param polygons struct to which the polygons are written
+ * @return int 0 on success, -1 if allocation failed or the context cannot
+ *         build polygons
+ */
+int voronoi_polygons(voronoi_ctx_t* ctx, point_t* points, int npoints,
+                     voronoi_polygons_t* polygons) {
+    box_t* box = &ctx->box;
+    point_t corners[4] = {{box->xmin, box->ymin}, {box->xmax, box->ymin},
+                          {box->xmax, box->ymax}, {box->xmin, box->ymax}};
+    point_t center = {(box->xmin + box->xmax) / 2, (box->ymin + box->ymax) / 2};
+    point_t *temp, *out, *first, *last;
+    voronoi_halfedge_t* halves = ctx->halfedges;
+    int *offsets, *lines, size, n, h, start, nearest = -1;
+    double d, best = INFINITY;
+
+    if (!ctx->clip || ctx->emit || !(ctx->flags & VORONOI_DCEL)) return -1;
+    if (npoints + 1 > ctx->polygon_offsets_size) {
+        if (!(offsets = realloc(ctx->polygon_offsets,
+                                (npoints + 1) * sizeof(int)))) return -1;
+        ctx->polygon_offsets = offsets;
+        ctx->polygon_offsets_size = npoints + 1;
+    }
+    /* every half-edge gives at most its two ends, every gap at most three
+       corners, and a cell without edges the four corners */
+    size = 4 * npoints + 10 * ctx->nedges;
+    if (size > ctx->polygon_vertices_size) {
+        if (!(temp = realloc(ctx->polygon_vertices, size * sizeof(point_t)))) {
+            return -1;
+        }
+        ctx->polygon_vertices = temp;
+        ctx->polygon_vertices_size = size;
+    }
+    /* the cells of collinear sites are bounded by up to two lines, which 
+       no vertex links, the one the cell does not point to is kept here */
+    if (!(lines = malloc((npoints + 1) * sizeof(int)))) return -1;
+    for (int i = 0; i < npoints; i++) lines[i] = -1;
+    for (int i = 0; i < 2 * ctx->nedges; i++) {
+        if (halves[i].origin < 0 && halves[halves[i].twin].origin < 0 &&
+            ctx->cells[halves[i].cell].halfedge != i) {
+            lines[halves[i].cell] = i;
+        }
+    }
+
+    offsets = ctx->polygon_offsets;
+    offsets[0] = 0;
+    for (int i = 0; i < npoints; i++) {
+        out = &ctx->polygon_vertices[offsets[i]];
+        first = last = NULL;
+        n = 0;
+        /* the boundary of an unbounded cell runs on from where it starts
+           at infinity up to the half-edge the cell points to */
+        if ((h = start = ctx->cells[i].halfedge) >= 0) {
+            n = polygon_run(ctx, &h, start, out, n, &first, &last);
+        }
+        if (start >= 0 && h < 0 && halves[start].prev >= 0) {
+            h = start;
+            for (int k = 0; k < 2 * ctx->nedges && halves[h].prev >= 0; k++) {
+                h = halves[h].prev;
+            }
+            n = polygon_run(ctx, &h, start, out, n, &first, &last);
+        }
+        if ((h = lines[i]) >= 0) {
+            n = polygon_run(ctx, &h, lines[i], out, n, &first, &last);
+        }
+        if (first) {
+            if (!point_equality(last, first)) {
+                n = polygon_corners(box, last, first, out, n);
+            }
+            if (n > 1 && point_equality(&out[n - 1], &out[0])) n--;
+        } else {
+            /* the cell holding the rectangle is that of the site nearest 
+               to any point of it */
+            if (nearest < 0) {
+                for (int k = 0; k < npoints; k++) {
+                    d = (points[k].x - center.x) * (points[k].x - center.x) +
+                        (points[k].y - center.y) * (points[k].y - center.y);
+                    if (d < best) {
+                        best = d;
+                        nearest = k;
+                    }
+                }
+            }
+            if (i == nearest) {
+                memcpy(out, corners, sizeof(corners));
+                n = 4;
+            }
+        }
+        offsets[i + 1] = offsets[i] + n;
+    }
+    free(lines);
+
+    polygons->vertices = ctx->polygon_vertices;
+    polygons->nvertices = offsets[npoints];
+    polygons->offsets = offsets;
+    polygons->npolygons = npoints;
+    return 0;
+}
+
+/**
+ * @brief reports how long the phases of the last compute_voronoi with a 
+ *        context took, both are 0 if it computed nothing or the diagram 
+ *        came from another function
+ * 
+ * @param ctx 
+ * @param timing struct to which the timings are written
+ */
+void voronoi_timing(voronoi_ctx_t* ctx, voronoi_timing_t* timing) {
+    *timing = ctx->timing;
+}
+
+/**
+ * @brief reports the counters of the last computation with a context, a 
+ *        parallel computation adds up those of its slabs and takes the 
+ *        largest of their maxima
+ * 
+ * @param ctx 
+ * @param stats struct to which the counters are written
+ * @return int 0 on success, -1 if the library was built without 
+ *         VORONOI_STATS and counts nothing
+ */
+int voronoi_stats(voronoi_ctx_t* ctx, voronoi_stats_t* stats) {
+    beachline_stats_t tree;
+
+    *stats = ctx->stats;
+    beachline_stats(ctx->beachline, &tree);
+    /* the slabs' beachlines and pools were counted by add_stats */
+    if (tree.searches) {
+        stats->mean_depth = (stats->mean_depth * stats->searches + 
+                             tree.depth) / (stats->searches + tree.searches);
+    }
+    stats->searches += tree.searches;
+    stats->breakpoint_tests += tree.depth;
+    if (tree.max_depth > stats->max_depth) stats->max_depth = tree.max_depth;
+    if (tree.max_size > stats->max_beachline) {
+        stats->max_beachline = tree.max_size;
+    }
+    stats->allocations += tree.allocations +
+                          pool_allocations(ctx->event_pool);
+#ifdef VORONOI_STATS
+    return 0;
+#else
+    return -1;
+#endif
+}
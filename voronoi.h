@@ -15,49 +15,201 @@
 #include <stdlib.h>
 #include "geometry.h"
 #include "priority_queue.h"
-#include "bst.h"
+#include "beachline.h"
+#include "pool.h"
 
-#define INTERSECT 0
-#define SINGLETON 1
 #define SITE_EVENT 0
 #define CIRCLE_EVENT 1
 #define LEFT_SIDE 0
 #define RIGHT_SIDE 1
-#define EPSILON 1e-9
 
-#define SYMMETRIC_LEQ(a, b) (((a) > (b))*(-2) + 1) // -1 if a > b, 1 if a <= b
-#define DOUBLE2VOID(doublevar) (*((void**) &doublevar)); //can only be used with named variables
+/* flags of voronoi_ctx_new */
+#define VORONOI_DCEL 1
+#define VORONOI_TRIANGLES 2
+/* with VORONOI_TRIANGLES, also records the neighbours of every triangle */
+#define VORONOI_NEIGHBOURS 4
 
+/* fewest sites per slab of compute_voronoi_parallel */
+#define PARALLEL_MIN_SITES 1024
 
-struct boundary {
-    char label;
-    point_t left_point;
-    point_t right_point;
-};
 
 struct event {
     char label;
     int tag;
     point_t sweep_event;
+    /* index of the input point of a site event */
+    int site;
+    /* indices of the input points of the three sites of a circle event,
+       their coordinates are those of the boundaries of its arc */
     struct {
-        point_t* left;
-        point_t* mid;
-        point_t* right;
+        int left;
+        int mid;
+        int right;
     } triplet;
+    /* center of the circle of a circle event, the voronoi vertex it adds */
+    point_t center;
+    /* beachline node of the left boundary of the arc a circle event 
+       dissolves */
+    beach_node_t* arc;
+    /* slot in the event queue, maintained by the queue */
+    int slot;
 };
 
-typedef struct boundary boundary_t;
+/* one side of a voronoi edge, the half-edges of edge i are 2i and 2i + 1,
+   lying in the cells of the first and second site of its dual */
+struct voronoi_halfedge {
+    /* vertex the half-edge starts at, -1 if it comes from infinity */
+    int origin;
+    int twin;
+    /* neighbouring half-edges counterclockwise around the cell, -1 where 
+       the boundary of an unbounded cell is open */
+    int next;
+    int prev;
+    /* index of the input point whose cell the half-edge bounds */
+    int cell;
+};
+
+struct voronoi_cell {
+    /* some half-edge of the cell, -1 if the cell has no edges, the 
+       boundary of an unbounded cell starts where following prev ends */
+    int halfedge;
+};
+
+/* doubly-connected edge list of a voronoi diagram, cells are indexed by 
+   input point */
+struct voronoi_dcel {
+    point_t* vertices;
+    int nvertices;
+    struct voronoi_halfedge* halfedges;
+    int nhalfedges;
+    struct voronoi_cell* cells;
+    int ncells;
+};
+
+/* delaunay triangles of a diagram, one per voronoi vertex the sweep 
+   found, so four or more cocircular sites are split into several */
+struct voronoi_triangulation {
+    /* indices of the input points of triangle i at 3i, 3i + 1 and 3i + 2,
+       in counterclockwise order */
+    int* triangles;
+    int ntriangles;
+    /* triangle across the side opposite corner 3i + k at 3i + k, -1 on the
+       convex hull, NULL without VORONOI_NEIGHBOURS */
+    int* neighbours;
+};
+
+/* cells of a diagram clipped to a rectangle, cell i is the polygon of 
+   vertices offsets[i] up to offsets[i + 1], in counterclockwise order, and
+   empty if the cell misses the rectangle */
+struct voronoi_polygons {
+    point_t* vertices;
+    int nvertices;
+    /* npolygons + 1 offsets into vertices */
+    int* offsets;
+    int npolygons;
+};
+
+/* one diagram of a batch computed by compute_voronoi_many */
+struct voronoi_job {
+    struct voronoi_ctx* ctx;
+    point_t* points;
+    int npoints;
+    /* result of compute_voronoi */
+    segment_t* edges;
+    int nedges;
+};
+
+/* wall clock seconds spent in the phases of the last compute_voronoi */
+struct voronoi_timing {
+    /* turning the points into site events sorted in sweep order */
+    double build;
+    /* sweeping the sites and the circle events */
+    double sweep;
+};
+
+/* counters of the last computation with a context, only collected by 
+   builds with VORONOI_STATS (make STATS=1) */
+struct voronoi_stats {
+    long site_events;
+    long circle_events;
+    /* circle events cancelled before the sweep reached them */
+    long stale_circle_events;
+    /* sites located against a boundary of the beachline */
+    long breakpoint_tests;
+    /* descents into the beachline and the boundaries they compared against */
+    long searches;
+    double mean_depth;
+    int max_depth;
+    /* most boundaries on the beachline and circle events queued at once */
+    int max_beachline;
+    int max_events;
+    /* events and beachline nodes taken from pools */
+    long allocations;
+    /* time spent processing each type of event */
+    double site_seconds;
+    double circle_seconds;
+    /* slabs compute_voronoi_parallel merged, 0 if it swept the sites on a
+       single thread */
+    int slabs;
+};
+
+struct voronoi_ctx;
+
 typedef struct event event_t;
+typedef struct voronoi_halfedge voronoi_halfedge_t;
+typedef struct voronoi_cell voronoi_cell_t;
+typedef struct voronoi_dcel voronoi_dcel_t;
+typedef struct voronoi_triangulation voronoi_triangulation_t;
+typedef struct voronoi_polygons voronoi_polygons_t;
+typedef struct voronoi_ctx voronoi_ctx_t;
+typedef struct voronoi_job voronoi_job_t;
+typedef struct voronoi_timing voronoi_timing_t;
+typedef struct voronoi_stats voronoi_stats_t;
 
 void event_print(void* e);
 
 void boundary_print(void* elem);
 
-event_t* new_event(char label, double x, double y, point_t* left, 
-                point_t* mid, point_t* right);
+event_t* new_event(pool_t* pool, int tag, char label, double x, double y,
+                   int left, int mid, int right);
 
 int event_compare(void* e1, void* e2);
 
-bst_t* compute_voronoi(pqueue_t* points);
+int* event_slot(void* e);
+
+voronoi_ctx_t* voronoi_ctx_new(int flags);
+
+void voronoi_ctx_clip(voronoi_ctx_t* ctx, box_t* box);
+
+void voronoi_ctx_reset(voronoi_ctx_t* ctx);
+
+void voronoi_ctx_free(voronoi_ctx_t* ctx);
+
+int compute_voronoi(voronoi_ctx_t* ctx, point_t* points, int npoints,
+                    segment_t** edgesp);
+
+int compute_voronoi_parallel(voronoi_ctx_t* ctx, point_t* points, int npoints,
+                             int nthreads, segment_t** edgesp);
+
+int compute_voronoi_many(voronoi_job_t* jobs, int njobs, int nthreads);
+
+int compute_voronoi_stream(voronoi_ctx_t* ctx,
+                           int (*next_site)(void*, point_t*), void* source,
+                           int (*emit)(void*, segment_t*, point_t*, point_t*),
+                           void* sink);
+
+int voronoi_dcel(voronoi_ctx_t* ctx, voronoi_dcel_t* dcel);
+
+int voronoi_triangulation(voronoi_ctx_t* ctx,
+                          voronoi_triangulation_t* triangulation);
+
+int voronoi_polygons(voronoi_ctx_t* ctx, point_t* points, int npoints,
+                     voronoi_polygons_t* polygons);
+
+void voronoi_timing(voronoi_ctx_t* ctx, voronoi_timing_t* timing);
+
+int voronoi_stats(voronoi_ctx_t* ctx, voronoi_stats_t* stats);
+
+double wall_seconds(void);
 
 #endif
\ No newline at end of file
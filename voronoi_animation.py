@@ -12,18 +12,20 @@ import time
 # setting up the points and their velocities
 np_points = np.random.uniform(low=-20, high= 20, size=(100,2))
 velocities = np.random.randn(100, 2) * 0.2 
-points = np_points.tolist()
-points= list(map(tuple, points))
 
-#computing voronoi/deluanay
-vor, deluan = voronoi.voronoi(points)
-vor_segments, vor_rays = vor
+#computing voronoi/deluanay, the context is reused by every frame, the 
+#arrays it returns are views into the context so they are only kept until
+#the next frame is computed
+context = voronoi.context()
+vertices, edges, delaunay = voronoi.voronoi(np_points, context)
+deluan = np_points[delaunay]
+del vertices, edges, delaunay
 
 # setting up the graph
 fig, ax = plt.subplots()
 ax.set_xlim(-25, 25)
 ax.set_ylim(-25, 25)
-scatter = ax.scatter(list(map(lambda x: x[0], points)), list(map(lambda x: x[1], points)), s = 1)
+scatter = ax.scatter(np_points[:, 0], np_points[:, 1], s = 1)
 line_segments = LineCollection(deluan, linestyles='solid', linewidths = (0.3))
 ax.add_collection(line_segments)
 ax.set_title('Voronoi diagram/Deluanay triangulation of randomly generated points')
@@ -41,16 +43,12 @@ def update(frame):
             velocities[i, 1] = -velocities[i, 1]
         velocities[i] += np.random.uniform(low=-1,high=1, size= (2,)) * 0.005
 
-    points = np_points.tolist()
+    scatter.set_offsets(np_points)
 
-    scatter.set_offsets(points)
+    #computing voronoi/deluanay, the points are passed without copying
+    vertices, edges, delaunay = voronoi.voronoi(np_points, context)
 
-    #computing voronoi/deluanay
-    points= list(map(tuple, points))
-    vor, deluan = voronoi.voronoi(points)
-    vor_segments, vor_rays = vor
-
-    line_segments.set_segments(deluan)
+    line_segments.set_segments(np_points[delaunay])
     
     return scatter, line_segments
 
@@ -0,0 +1,219 @@
+/**
+ * @file voronoi_bench.c
+ * @author Diram Tabaa (dtabaa@andrew.cmu.edu)
+ * @brief benchmark of the voronoi executable's pipeline on the point
+ *        distributions of tests/generate_test.py, prints one comma separated
+ *        line per distribution and size
+ * @version 0.1
+ * @date 2024-04-10
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "voronoi.h"
+#include "text.h"
+
+/* number of gaussian clusters and their standard deviation */
+#define CLUSTERS 16
+#define CLUSTER_SIGMA 1.0
+
+/* math.h only defines M_PI outside of strict c99 */
+#define PI 3.14159265358979323846
+
+typedef void (*generator_t)(point_t*, int);
+
+double uniform(double lo, double hi) {
+    return lo + (hi - lo) * rand() / RAND_MAX;
+}
+
+/**
+ * @brief draws a standard normal variate with the Box-Muller transform
+ */
+double gaussian(void) {
+    double u = (rand() + 1.0) / (RAND_MAX + 1.0);
+    return sqrt(-2 * log(u)) * cos(2 * PI * rand() / RAND_MAX);
+}
+
+/* get_random_point(-19, 19, -19, 19) */
+void gen_uniform(point_t* points, int n) {
+    for (int i = 0; i < n; i++) {
+        points[i].x = uniform(-19, 19);
+        points[i].y = uniform(-19, 19);
+    }
+}
+
+/* normal clusters around centers drawn like get_random_point */
+void gen_clustered(point_t* points, int n) {
+    point_t centers[CLUSTERS];
+    int c;
+
+    for (int i = 0; i < CLUSTERS; i++) {
+        centers[i].x = uniform(-19, 19);
+        centers[i].y = uniform(-19, 19);
+    }
+    for (int i = 0; i < n; i++) {
+        c = rand() % CLUSTERS;
+        points[i].x = centers[c].x + CLUSTER_SIGMA * gaussian();
+        points[i].y = centers[c].y + CLUSTER_SIGMA * gaussian();
+    }
+}
+
+/* space_fill_triangles, extended to as many rows of ceil(sqrt(n)) points
+   as it takes */
+void gen_grid(point_t* points, int n) {
+    int side = (int) ceil(sqrt(n));
+
+    for (int i = 0; i < n; i++) {
+        points[i].x = 5 * (i % side) - 22;
+        points[i].y = 5 * (i / side) - 22;
+    }
+}
+
+/* get_circular_point(5, -5, -5, i, n) */
+void gen_circle(point_t* points, int n) {
+    double angle;
+
+    for (int i = 0; i < n; i++) {
+        angle = (double) i / n * 2 * PI;
+        points[i].x = 5 * cos(angle) - 5;
+        points[i].y = 5 * sin(angle) - 5;
+    }
+}
+
+/* get_convex_points(9, 0, 0, i, n) */
+void gen_parabola(point_t* points, int n) {
+    for (int i = 0; i < n; i++) {
+        points[i].x = (double) i / n * 9;
+        points[i].y = 0.2 * points[i].x * points[i].x;
+    }
+}
+
+/**
+ * @brief writes points to a temporary file in the input format
+ * 
+ * @param path template of the file name, see mkstemp
+ * @param points
+ * @param n number of points
+ * @return int 0 if successful, -1 otherwise
+ */
+int write_input(char* path, point_t* points, int n) {
+    text_writer_t writer;
+    char count[16];
+    FILE* file;
+    int fd, status;
+
+    if ((fd = mkstemp(path)) < 0) return -1;
+    if (!(file = fdopen(fd, "w"))) {
+        close(fd);
+        return -1;
+    }
+    if (text_writer_init(&writer, file)) {
+        fclose(file);
+        return -1;
+    }
+    snprintf(count, sizeof(count), "%d\n", n);
+    text_write(&writer, count);
+    for (int i = 0; i < n; i++) {
+        text_write_double(&writer, points[i].x);
+        text_write(&writer, " ");
+        text_write_double(&writer, points[i].y);
+        text_write(&writer, "\n");
+    }
+    status = text_writer_flush(&writer);
+    text_writer_free(&writer);
+    return fclose(file) || status ? -1 : 0;
+}
+
+/**
+ * @brief times the phases of the executable on n generated points, reading
+ *        them from a text file, sorting the site events, sweeping and
+ *        writing the text output to /dev/null
+ * 
+ * @param ctx context reused across runs
+ * @param name name of the distribution
+ * @param generate fills an array with the distribution
+ * @param n number of points
+ * @return int 0 if successful, -1 otherwise
+ */
+int bench_run(voronoi_ctx_t* ctx, char* name, generator_t generate, int n) {
+    char path[] = "/tmp/voronoi_benchXXXXXX";
+    point_t *generated, *points;
+    segment_t* edges;
+    voronoi_timing_t timing;
+    text_writer_t writer;
+    FILE* sink;
+    double start, input_s, output_s;
+    int npoints, nedges;
+
+    if (!(generated = malloc(n * sizeof(point_t)))) return -1;
+    generate(generated, n);
+    if (write_input(path, generated, n)) {
+        free(generated);
+        return -1;
+    }
+    free(generated);
+
+    start = wall_seconds();
+    npoints = text_read_points(path, &points);
+    input_s = wall_seconds() - start;
+    unlink(path);
+    if (npoints != n) return -1;
+
+    if ((nedges = compute_voronoi(ctx, points, npoints, &edges)) < 0) {
+        free(points);
+        return -1;
+    }
+    voronoi_timing(ctx, &timing);
+
+    if (!(sink = fopen("/dev/null", "w"))) {
+        free(points);
+        return -1;
+    }
+    start = wall_seconds();
+    if (text_writer_init(&writer, sink)) {
+        fclose(sink);
+        free(points);
+        return -1;
+    }
+    text_write_points(&writer, points, npoints);
+    text_write_segments(&writer, edges, nedges, points);
+    text_writer_flush(&writer);
+    text_writer_free(&writer);
+    output_s = wall_seconds() - start;
+    fclose(sink);
+
+    printf("%s,%d,%d,%.6f,%.6f,%.6f,%.6f,%.0f\n", name, n, nedges, input_s,
+           timing.build, timing.sweep, output_s,
+           n / (timing.build + timing.sweep));
+    fflush(stdout);
+    free(points);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    char* names[] = {"uniform", "clustered", "grid", "circle", "parabola"};
+    generator_t generators[] = {gen_uniform, gen_clustered, gen_grid,
+                                gen_circle, gen_parabola};
+    int max_size = argc > 1 ? atoi(argv[1]) : 10000000;
+    voronoi_ctx_t* ctx;
+
+    if (!(ctx = voronoi_ctx_new(0))) return 1;
+    srand(0);
+    printf("distribution,sites,edges,input_s,build_s,sweep_s,output_s,"
+           "sites_per_s\n");
+    for (int d = 0; d < 5; d++) {
+        for (int n = 1000; n <= max_size; n *= 10) {
+            if (bench_run(ctx, names[d], generators[d], n)) {
+                voronoi_ctx_free(ctx);
+                return 1;
+            }
+        }
+    }
+    voronoi_ctx_free(ctx);
+    return 0;
+}
@@ -8,36 +8,245 @@
  * @copyright Copyright (c) 2024
  * 
  */
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 #include "voronoi.h"
+#include "stream.h"
+#include "binary.h"
+#include "text.h"
 
+/* formats of -i and -o */
+#define FORMAT_TEXT 0
+#define FORMAT_BINARY 1
 
+/* size of the stdout buffer for binary output */
+#define OUTPUT_BUFFER (1 << 20)
 
-int parse_input(char* filename, pqueue_t* events) {
-    FILE* input;
+
+
+/**
+ * @brief prints the counters of the last computation with a context to 
+ *        stderr, one name and value per line
+ * 
+ * @param ctx 
+ */
+void print_stats(voronoi_ctx_t* ctx) {
+    voronoi_stats_t stats;
+
+    voronoi_stats(ctx, &stats);
+    fprintf(stderr, "site_events %ld\n", stats.site_events);
+    fprintf(stderr, "circle_events %ld\n", stats.circle_events);
+    fprintf(stderr, "stale_circle_events %ld\n", stats.stale_circle_events);
+    fprintf(stderr, "breakpoint_tests %ld\n", stats.breakpoint_tests);
+    fprintf(stderr, "searches %ld\n", stats.searches);
+    fprintf(stderr, "mean_depth %.2f\n", stats.mean_depth);
+    fprintf(stderr, "max_depth %d\n", stats.max_depth);
+    fprintf(stderr, "max_beachline %d\n", stats.max_beachline);
+    fprintf(stderr, "max_events %d\n", stats.max_events);
+    fprintf(stderr, "allocations %ld\n", stats.allocations);
+    fprintf(stderr, "site_seconds %.6f\n", stats.site_seconds);
+    fprintf(stderr, "circle_seconds %.6f\n", stats.circle_seconds);
+    fprintf(stderr, "slabs %d\n", stats.slabs);
+}
+
+/**
+ * @brief reads the input points into sorted runs, only run_sites of which
+ *        are held in memory at once
+ * 
+ * @param filename path to the input file
+ * @param format FORMAT_TEXT or FORMAT_BINARY
+ * @param runs runs to which the points are added
+ * @param out writer to which the points are echoed
+ * @return int number of points read, -1 on failure
+ */
+int stream_input(char* filename, int format, site_runs_t* runs,
+                 text_writer_t* out) {
+    text_reader_t reader;
     int args;
-    double x, y;
-    event_t* event;
+    point_t point;
+    binary_sites_t sites;
 
-    input = fopen(filename, "r");
-    if (fscanf(input, "%d\n", &args) < 1) return -1;
+    if (format == FORMAT_BINARY) {
+        if (binary_map_sites(&sites, filename)) return -1;
+        for (int i = 0; i < sites.npoints; i++) {
+            if (site_runs_add(runs, &sites.points[i])) {
+                binary_unmap_sites(&sites);
+                return -1;
+            }
+        }
+        text_write_points(out, sites.points, sites.npoints);
+        args = sites.npoints;
+        binary_unmap_sites(&sites);
+        return site_runs_finish(runs) ? -1 : args;
+    }
+    if (text_reader_open(&reader, filename)) return -1;
+    if ((args = text_read_count(&reader)) < 0) {
+        text_reader_close(&reader);
+        return -1;
+    }
     for (int i = 0; i < args; i++) {
-        if (fscanf(input, "%lf %lf\n", &x, &y) < 2) return -1;
-        printf("[%f, %f], ", x, y);
-        event = new_event(SITE_EVENT, x, y, NULL, NULL, NULL);
-        pqueue_insert(events, event);
+        if (text_read_point(&reader, &point) || site_runs_add(runs, &point)) {
+            text_reader_close(&reader);
+            return -1;
+        }
+        text_write_point(out, &point);
+        text_write(out, ", ");
     }
-    printf("\n");
-    return 0;
+    text_write(out, "\n");
+    text_reader_close(&reader);
+    return site_runs_finish(runs) ? -1 : args;
 }
 
+/**
+ * @brief computes the diagram of a file too large to be held in memory, 
+ *        the points are sorted externally and every edge is written as 
+ *        soon as it is final
+ * 
+ * @param filename path to the input file
+ * @param format FORMAT_TEXT or FORMAT_BINARY
+ * @param run_sites number of points sorted in memory at once
+ * @param show_stats whether to print the counters of the computation
+ * @param out writer of the output
+ * @return int 0 on success, -1 on failure
+ */
+int stream_voronoi(char* filename, int format, int run_sites, int show_stats,
+                   text_writer_t* out) {
+    site_runs_t* runs;
+    voronoi_ctx_t* ctx;
+    int status = -1;
+
+    if (!(runs = site_runs_new(run_sites))) return -1;
+    if (stream_input(filename, format, runs, out) >= 0 &&
+        (ctx = voronoi_ctx_new(0))) {
+        if (compute_voronoi_stream(ctx, site_runs_next, runs,
+                                   text_write_segment, out) >= 0) status = 0;
+        text_write(out, "\n");
+        if (show_stats) print_stats(ctx);
+        voronoi_ctx_free(ctx);
+    }
+    site_runs_free(runs);
+    return status;
+}
+
+void usage(char* name) {
+    fprintf(stderr, "usage: %s [-i text|binary] [-o text|binary] "
+            "[-t threads | -s [-m run_sites]] [-S] input_file\n", name);
+}
+
+int parse_format(char* name) {
+    if (!strcmp(name, "text")) return FORMAT_TEXT;
+    if (!strcmp(name, "binary")) return FORMAT_BINARY;
+    return -1;
+}
+
+/**
+ * @brief usage: voronoi [-i text|binary] [-o text|binary] 
+ *        [-t threads | -s [-m run_sites]] [-S] input_file, -i and -o 
+ *        select the formats of the input and the output, both text by 
+ *        default, with -t the diagram is computed in parallel on the given
+ *        number of threads, 0 for one per processor, which only writes 
+ *        text, with -s the points are streamed through the sweep, sorted 
+ *        run_sites at a time, which only writes text as well, -S prints the counters of the computation to stderr
+ *        and needs a build with make STATS=1
+ */
 int main(int argc, char** argv) {
-    pqueue_t* pq = pqueue_new(*event_compare);
-    bst_t* voronoi;
-    parse_input(argv[1], pq);
-    voronoi = compute_voronoi(pq);
-    bst_print(voronoi, *segment_print);
-    printf("\n");
-    pqueue_free(pq);
-    return 0;
-}
\ No newline at end of file
+    point_t* points;
+    int npoints, nedges, opt, threads = 1, stream = 0, run_sites = RUN_SITES;
+    int input_format = FORMAT_TEXT, output_format = FORMAT_TEXT, status = 0;
+    int show_stats = 0;
+    segment_t* edges;
+    voronoi_ctx_t* ctx;
+    voronoi_dcel_t dcel;
+    binary_sites_t sites;
+    text_writer_t out;
+
+    while ((opt = getopt(argc, argv, "i:o:t:sm:S")) != -1) {
+        switch (opt) {
+            case 'i':
+                input_format = parse_format(optarg);
+                break;
+            case 'o':
+                output_format = parse_format(optarg);
+                break;
+            case 't':
+                threads = atoi(optarg);
+                break;
+            case 's':
+                stream = 1;
+                break;
+            case 'm':
+                run_sites = atoi(optarg);
+                break;
+            case 'S':
+                show_stats = 1;
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (optind >= argc || input_format < 0 || output_format < 0 ||
+        (stream && (threads != 1 || output_format != FORMAT_TEXT))) {
+        usage(argv[0]);
+        return 1;
+    }
+#ifndef VORONOI_STATS
+    if (show_stats) {
+        fprintf(stderr, "%s: -S needs a build with make STATS=1\n", argv[0]);
+        return 1;
+    }
+#endif
+    /* the merge of compute_voronoi_parallel builds no topology, so it 
+       would silently fall back to a single thread */
+    if (threads != 1 && output_format == FORMAT_BINARY) {
+        fprintf(stderr, "%s: -o binary needs the topology only a single "
+                "thread builds, drop -t\n", argv[0]);
+        return 1;
+    }
+    if (stream) {
+        if (text_writer_init(&out, stdout)) return 1;
+        status = stream_voronoi(argv[optind], input_format, run_sites,
+                                show_stats, &out);
+        if (text_writer_flush(&out)) status = -1;
+        text_writer_free(&out);
+        return status ? 1 : 0;
+    }
+
+    if (input_format == FORMAT_BINARY) {
+        if (binary_map_sites(&sites, argv[optind])) return 1;
+        points = sites.points;
+        npoints = sites.npoints;
+    } else if ((npoints = text_read_points(argv[optind], &points)) < 0) {
+        return 1;
+    }
+    /* the binary output indexes vertices, which takes the topology */
+    if (!(ctx = voronoi_ctx_new(output_format == FORMAT_BINARY ?
+                                VORONOI_DCEL : 0))) return 1;
+    if (threads == 1) {
+        nedges = compute_voronoi(ctx, points, npoints, &edges);
+    } else {
+        nedges = compute_voronoi_parallel(ctx, points, npoints, threads,
+                                          &edges);
+    }
+    if (nedges < 0) return 1;
+    if (show_stats) print_stats(ctx);
+    if (output_format == FORMAT_BINARY) {
+        setvbuf(stdout, NULL, _IOFBF, OUTPUT_BUFFER);
+        if (voronoi_dcel(ctx, &dcel) ||
+            binary_write_diagram(stdout, points, npoints, &dcel) ||
+            fflush(stdout)) status = 1;
+    } else if (!text_writer_init(&out, stdout)) {
+        text_write_points(&out, points, npoints);
+        text_write_segments(&out, edges, nedges, points);
+        if (text_writer_flush(&out)) status = 1;
+        text_writer_free(&out);
+    } else {
+        status = 1;
+    }
+    voronoi_ctx_free(ctx);
+    if (input_format == FORMAT_BINARY) binary_unmap_sites(&sites);
+    else free(points);
+    return status;
+}
@@ -1,71 +1,806 @@
 #include "Python.h"
 #include "voronoi.h"
 
-static PyObject *parse_voronoi(bst_t* voronoi) {
+/**
+ * @brief appends a new reference to a list and drops it, the list keeping
+ *        its own
+ *
+ * @param list
+ * @param item new reference, NULL if building it failed
+ * @return int 0 on success, -1 on failure
+ */
+static int list_append_new(PyObject *list, PyObject *item) {
+    int status;
+    if (!item) return -1;
+    status = PyList_Append(list, item);
+    Py_DECREF(item);
+    return status;
+}
+
+static PyObject *parse_voronoi(segment_t* edges, int nedges, point_t* points) {
     segment_t* segment;
+    point_t *dp1, *dp2;
     PyObject *voronoi_segments = PyList_New(0);
     PyObject *voronoi_rays = PyList_New(0);
     PyObject *delaunay_segments  = PyList_New(0);
-    while (!bst_rootkey(voronoi, &segment)) {
-        PyObject *v_item;
-        PyObject *d_item;     
-        if (segment->label == SEG_SEG) {
-            v_item = Py_BuildValue("((dd)(dd))", segment->options.seg.p1.x, 
-                            segment->options.seg.p1.y, 
-                            segment->options.seg.p2.x,
-                            segment->options.seg.p2.y);
-            PyList_Append(voronoi_segments, v_item);                 
+    if (!voronoi_segments || !voronoi_rays || !delaunay_segments) goto fail;
+    for (int i = 0; i < nedges; i++) {
+        segment = &edges[i];
+        if (segment->label == SEG_OUTSIDE) {
+            /* clipped away, its dual is still part of the triangulation */
+        } else if (segment->label == SEG_SEG) {
+            if (list_append_new(voronoi_segments,
+                                Py_BuildValue("((dd)(dd))",
+                                              segment->options.seg.p1.x, 
+                                              segment->options.seg.p1.y, 
+                                              segment->options.seg.p2.x,
+                                              segment->options.seg.p2.y)))
+                goto fail;
         } else {
-            v_item = Py_BuildValue("(ddd)", segment->options.ray.p.x,
-                                   segment->options.ray.p.y, 
-                                   segment->options.ray.gradient);
-            PyList_Append(voronoi_rays, v_item);   
+            if (list_append_new(voronoi_rays,
+                                Py_BuildValue("(ddd)",
+                                              segment->options.ray.p.x,
+                                              segment->options.ray.p.y, 
+                                              segment->options.ray.gradient)))
+                goto fail;
         }
-        d_item = Py_BuildValue("((dd)(dd))", segment->dual.p1.x, 
-                        segment->dual.p1.y, 
-                        segment->dual.p2.x,
-                        segment->dual.p2.y);
-        PyList_Append(delaunay_segments, d_item);  
-        bst_delete(voronoi, segment, NULL, NULL);
+        dp1 = &points[segment->dual.site1];
+        dp2 = &points[segment->dual.site2];
+        if (list_append_new(delaunay_segments,
+                            Py_BuildValue("((dd)(dd))", dp1->x, dp1->y,
+                                          dp2->x, dp2->y)))
+            goto fail;
     }
-    return Py_BuildValue("((OO)O)", voronoi_segments, voronoi_rays, delaunay_segments);
+    /* N hands the references of the lists over to the tuples */
+    return Py_BuildValue("((NN)N)", voronoi_segments, voronoi_rays,
+                         delaunay_segments);
+
+fail:
+    Py_XDECREF(voronoi_segments);
+    Py_XDECREF(voronoi_rays);
+    Py_XDECREF(delaunay_segments);
+    return NULL;
+}
+
+/***********/
+/* CONTEXT */
+/***********/
+
+/* a context and the number of arrays still exporting its buffers, which
+   must not be recomputed while any of them is alive, nor while another 
+   call is computing with it, from another thread or from the Python code
+   its points run */
+typedef struct {
+    PyObject_HEAD
+    voronoi_ctx_t* ctx;
+    /* flags the context was created with */
+    int flags;
+    Py_ssize_t exports;
+    int busy;
+} ContextObject;
+
+static void context_dealloc(ContextObject *self) {
+    if (self->ctx) voronoi_ctx_free(self->ctx);
+    Py_TYPE(self)->tp_free((PyObject*) self);
+}
+
+static PyTypeObject ContextType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "voronoi.Context",
+    .tp_doc = "Memory kept by voronoi() between calls.",
+    .tp_basicsize = sizeof(ContextObject),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = (destructor) context_dealloc,
+};
+
+static PyObject *context_new(int flags) {
+    ContextObject *self;
+    if (!(self = PyObject_New(ContextObject, &ContextType))) return NULL;
+    self->flags = flags;
+    self->exports = 0;
+    self->busy = 0;
+    if (!(self->ctx = voronoi_ctx_new(flags))) {
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+    return (PyObject*) self;
+}
+
+/* flags of the contexts of delaunay() */
+#define TRIANGLE_FLAGS (VORONOI_DCEL | VORONOI_TRIANGLES | VORONOI_NEIGHBOURS)
+
+static PyObject *context(PyObject *self, PyObject *args, PyObject *kwargs) {
+    static char *kwlist[] = {"triangles", NULL};
+    int triangles = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|p", kwlist, &triangles))
+        return NULL;
+    return context_new(triangles ? TRIANGLE_FLAGS : VORONOI_DCEL);
 }
 
-static PyObject *voronoi(PyObject *self, PyObject *args) {
-    PyObject *vertices_list;
-    int vertices_count;
-    bst_t* voronoi_list;
-    pqueue_t* pq;
-    event_t* event;
-    double x, y;
+/**
+ * @brief takes a reference to the context a computation is to use, a new
+ *        one if none was passed, and marks it busy until context_release,
+ *        parsing the points may run Python code, a __float__ say, which 
+ *        must not reuse the context from under the computation
+ *
+ * @param owner context argument, Py_None if there is none
+ * @param flags flags of a new context, which a passed one must include
+ * @return ContextObject* new reference, NULL on failure
+ */
+static ContextObject *context_acquire(PyObject *owner, int flags) {
+    ContextObject *context = (ContextObject*) owner;
 
-    if (!PyArg_ParseTuple(args, "O", &vertices_list))
+    if (owner == Py_None) {
+        if (!(context = (ContextObject*) context_new(flags))) return NULL;
+        context->busy = 1;
+        return context;
+    }
+    if (!PyObject_TypeCheck(owner, &ContextType)) {
+        PyErr_SetString(PyExc_TypeError, "context must be a voronoi context");
+        return NULL;
+    }
+    if ((context->flags & flags) != flags) {
+        PyErr_SetString(PyExc_ValueError, "context must be created with "
+                        "context(triangles=True)");
+        return NULL;
+    }
+    if (context->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "context is in use by another "
+                        "call");
         return NULL;
+    }
+    if (context->exports) {
+        PyErr_SetString(PyExc_BufferError, "context is still exporting "
+                        "the arrays of its previous result");
+        return NULL;
+    }
+    Py_INCREF(context);
+    context->busy = 1;
+    return context;
+}
+
+/**
+ * @brief ends a computation with a context taken by context_acquire
+ *
+ * @param context 
+ */
+static void context_release(ContextObject *context) {
+    context->busy = 0;
+    Py_DECREF(context);
+}
+
+/***********/
+/*  ARRAY  */
+/***********/
+
+/* read-only two dimensional view of an output buffer of a context, the
+   context is kept alive and locked for as long as the view is */
+typedef struct {
+    PyObject_HEAD
+    ContextObject* owner;
+    void* buf;
+    char* format;
+    Py_ssize_t itemsize;
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+} ArrayObject;
+
+static int array_getbuffer(ArrayObject *self, Py_buffer *view, int flags) {
+    if (flags & PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "voronoi arrays are read-only");
+        return -1;
+    }
+    if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES &&
+        self->strides[0] != self->shape[1] * self->strides[1]) {
+        PyErr_SetString(PyExc_BufferError, "voronoi array is not contiguous");
+        return -1;
+    }
+    view->obj = (PyObject*) self;
+    Py_INCREF(self);
+    view->buf = self->buf;
+    view->len = self->shape[0] * self->shape[1] * self->itemsize;
+    view->readonly = 1;
+    view->itemsize = self->itemsize;
+    view->format = (flags & PyBUF_FORMAT) ? self->format : NULL;
+    view->ndim = 2;
+    view->shape = (flags & PyBUF_ND) ? self->shape : NULL;
+    view->strides = (flags & PyBUF_STRIDES) ? self->strides : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    return 0;
+}
 
-    vertices_count = PyObject_Length(vertices_list);
-    pq  = pqueue_new(*event_compare);
+static PyBufferProcs array_as_buffer = {
+    .bf_getbuffer = (getbufferproc) array_getbuffer,
+};
+
+static void array_dealloc(ArrayObject *self) {
+    self->owner->exports--;
+    Py_DECREF(self->owner);
+    Py_TYPE(self)->tp_free((PyObject*) self);
+}
+
+static PyTypeObject ArrayType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "voronoi.Array",
+    .tp_doc = "Read-only view of an output buffer of a voronoi context.",
+    .tp_basicsize = sizeof(ArrayObject),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = (destructor) array_dealloc,
+    .tp_as_buffer = &array_as_buffer,
+};
 
+/* numpy.asarray if numpy can be imported, None otherwise */
+static PyObject *asarray_fn = NULL;
 
-    for (int index = 0; index < vertices_count; index++) {
-        PyObject *item;
-        item = PyList_GetItem(vertices_list, index);
-        if(!PyArg_ParseTuple(item, "dd", &x, &y)) {
-            return NULL;
+/**
+ * @brief wraps an output buffer of a context as a numpy array without
+ *        copying it, or as a memoryview if numpy is not installed
+ *
+ * @param owner context owning the buffer
+ * @param buf address of the first item
+ * @param format struct format of the items
+ * @param itemsize size of an item in bytes
+ * @param rows number of rows
+ * @param cols number of items per row
+ * @param row_stride distance between rows in bytes
+ * @param col_stride distance between the items of a row in bytes
+ * @return PyObject* new reference, NULL on failure
+ */
+static PyObject *array_new(ContextObject *owner, void* buf, char* format,
+                           Py_ssize_t itemsize, Py_ssize_t rows,
+                           Py_ssize_t cols, Py_ssize_t row_stride,
+                           Py_ssize_t col_stride) {
+    static double empty[2];
+    ArrayObject *array;
+    PyObject *numpy, *result;
+
+    if (!asarray_fn) {
+        if ((numpy = PyImport_ImportModule("numpy"))) {
+            asarray_fn = PyObject_GetAttrString(numpy, "asarray");
+            Py_DECREF(numpy);
+        }
+        if (!asarray_fn) {
+            PyErr_Clear();
+            asarray_fn = Py_None;
+            Py_INCREF(asarray_fn);
         }
-        event = new_event(SITE_EVENT, x, y, NULL, NULL, NULL);
-        pqueue_insert(pq, event);
     }
-    voronoi_list = compute_voronoi(pq);
-    return parse_voronoi(voronoi_list);
+
+    if (!(array = PyObject_New(ArrayObject, &ArrayType))) return NULL;
+    Py_INCREF(owner);
+    owner->exports++;
+    array->owner = owner;
+    array->buf = rows ? buf : empty;
+    array->format = format;
+    array->itemsize = itemsize;
+    array->shape[0] = rows;
+    array->shape[1] = cols;
+    array->strides[0] = row_stride;
+    array->strides[1] = col_stride;
+
+    if (asarray_fn == Py_None)
+        result = PyMemoryView_FromObject((PyObject*) array);
+    else
+        result = PyObject_CallOneArg(asarray_fn, (PyObject*) array);
+    Py_DECREF(array);
+    return result;
+}
+
+/**
+ * @brief builds the array result of voronoi(), every array is a view of
+ *        the topology held by the context
+ *
+ * @param owner context that computed the diagram
+ * @return PyObject* (vertices, edges, delaunay)
+ */
+static PyObject *voronoi_arrays(ContextObject *owner) {
+    voronoi_dcel_t dcel;
+    PyObject *vertices, *edges, *delaunay, *result;
+    Py_ssize_t stride = 2 * sizeof(voronoi_halfedge_t);
+
+    voronoi_dcel(owner->ctx, &dcel);
+    vertices = array_new(owner, dcel.vertices, "d", sizeof(double),
+                         dcel.nvertices, 2, sizeof(point_t), sizeof(double));
+    edges = array_new(owner, &dcel.halfedges->origin, "i", sizeof(int),
+                      dcel.nhalfedges / 2, 2, stride, stride / 2);
+    delaunay = array_new(owner, &dcel.halfedges->cell, "i", sizeof(int),
+                         dcel.nhalfedges / 2, 2, stride, stride / 2);
+    if (vertices && edges && delaunay)
+        result = PyTuple_Pack(3, vertices, edges, delaunay);
+    else
+        result = NULL;
+    Py_XDECREF(vertices);
+    Py_XDECREF(edges);
+    Py_XDECREF(delaunay);
+    return result;
+}
+
+/**
+ * @brief builds the array result of voronoi() with a clip rectangle, views
+ *        of the edges held by the context, every edge is a segment by then,
+ *        or SEG_OUTSIDE with NaN points
+ *
+ * @param owner context that computed the diagram
+ * @param edges edges of the diagram
+ * @param nedges number of edges
+ * @return PyObject* (segments, delaunay)
+ */
+static PyObject *clipped_arrays(ContextObject *owner, segment_t* edges,
+                                int nedges) {
+    PyObject *segments, *delaunay, *result;
+
+    segments = array_new(owner, &edges->options.seg.p1.x, "d",
+                         sizeof(double), nedges, 4, sizeof(segment_t),
+                         sizeof(double));
+    delaunay = array_new(owner, &edges->dual.site1, "i", sizeof(int),
+                         nedges, 2, sizeof(segment_t), sizeof(int));
+    if (segments && delaunay)
+        result = PyTuple_Pack(2, segments, delaunay);
+    else
+        result = NULL;
+    Py_XDECREF(segments);
+    Py_XDECREF(delaunay);
+    return result;
+}
+
+/**
+ * @brief builds the result of delaunay(), views of the triangles held by 
+ *        the context
+ *
+ * @param owner context that computed the triangles
+ * @return PyObject* (triangles, neighbours)
+ */
+static PyObject *triangle_arrays(ContextObject *owner) {
+    voronoi_triangulation_t triangulation;
+    PyObject *triangles, *neighbours, *result;
+
+    voronoi_triangulation(owner->ctx, &triangulation);
+    triangles = array_new(owner, triangulation.triangles, "i", sizeof(int),
+                          triangulation.ntriangles, 3, 3 * sizeof(int),
+                          sizeof(int));
+    neighbours = array_new(owner, triangulation.neighbours, "i", sizeof(int),
+                           triangulation.ntriangles, 3, 3 * sizeof(int),
+                           sizeof(int));
+    if (triangles && neighbours)
+        result = PyTuple_Pack(2, triangles, neighbours);
+    else
+        result = NULL;
+    Py_XDECREF(triangles);
+    Py_XDECREF(neighbours);
+    return result;
+}
+
+/**
+ * @brief builds the result of cells(), views of the polygons held by the
+ *        context, the bounds of consecutive cells overlap in memory
+ *
+ * @param owner context that built the polygons
+ * @param polygons the polygons
+ * @return PyObject* (vertices, bounds)
+ */
+static PyObject *polygon_arrays(ContextObject *owner,
+                                voronoi_polygons_t* polygons) {
+    PyObject *vertices, *bounds, *result;
+
+    vertices = array_new(owner, polygons->vertices, "d", sizeof(double),
+                         polygons->nvertices, 2, sizeof(point_t),
+                         sizeof(double));
+    bounds = array_new(owner, polygons->offsets, "i", sizeof(int),
+                       polygons->npolygons, 2, sizeof(int), sizeof(int));
+    if (vertices && bounds)
+        result = PyTuple_Pack(2, vertices, bounds);
+    else
+        result = NULL;
+    Py_XDECREF(vertices);
+    Py_XDECREF(bounds);
+    return result;
+}
+
+/**
+ * @brief reads a clip rectangle given as (xmin, ymin, xmax, ymax)
+ *
+ * @param clip the rectangle, Py_None for none
+ * @param box struct to which the rectangle is written
+ * @return box_t* box, NULL if clip is None or on failure, which sets an 
+ *         exception
+ */
+static box_t *parse_clip(PyObject *clip, box_t *box) {
+    if (clip == Py_None) return NULL;
+    if (!PyArg_ParseTuple(clip, "dddd", &box->xmin, &box->ymin, &box->xmax,
+                          &box->ymax))
+        return NULL;
+    if (box->xmin > box->xmax || box->ymin > box->ymax) {
+        PyErr_SetString(PyExc_ValueError, "clip must be (xmin, ymin, xmax, "
+                        "ymax) with xmin <= xmax and ymin <= ymax");
+        return NULL;
+    }
+    return box;
 }
 
-char voronoifunc_docs[] = "Hello world description.";
+/**
+ * @brief reads the input points of voronoi(), buffers of shape (N, 2) are
+ *        used in place and anything else is parsed as a list of pairs
+ *
+ * @param vertices_list input points
+ * @param view buffer of the points, its obj is NULL if they were copied
+ * @param pointsp pointer to which the points are written
+ * @return Py_ssize_t number of points, -1 on failure
+ */
+static Py_ssize_t parse_points(PyObject *vertices_list, Py_buffer *view,
+                               point_t** pointsp) {
+    Py_ssize_t vertices_count;
+    PyObject *seq;
+    point_t* points;
+
+    view->obj = NULL;
+    if (PyObject_CheckBuffer(vertices_list)) {
+        if (PyObject_GetBuffer(vertices_list, view,
+                               PyBUF_C_CONTIGUOUS | PyBUF_FORMAT))
+            return -1;
+        if (view->ndim != 2 || view->shape[1] != 2 ||
+            view->itemsize != sizeof(double) || strcmp(view->format, "d")) {
+            PyBuffer_Release(view);
+            PyErr_SetString(PyExc_ValueError,
+                            "points must be a float64 array of shape (N, 2)");
+            return -1;
+        }
+        if (view->shape[0] > INT_MAX) {
+            PyBuffer_Release(view);
+            PyErr_SetString(PyExc_OverflowError, "too many points");
+            return -1;
+        }
+        *pointsp = view->buf;
+        return view->shape[0];
+    }
+
+    /* any sequence of pairs is accepted, PySequence_Fast turns it into a 
+       list or tuple whose items can be read without new references */
+    if (!(seq = PySequence_Fast(vertices_list, "points must be a sequence "
+                                "of (x, y) pairs")))
+        return -1;
+    vertices_count = PySequence_Fast_GET_SIZE(seq);
+    if (vertices_count > INT_MAX) {
+        Py_DECREF(seq);
+        PyErr_SetString(PyExc_OverflowError, "too many points");
+        return -1;
+    }
+    if (!(points = PyMem_Malloc((vertices_count + 1) * sizeof(point_t)))) {
+        Py_DECREF(seq);
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for (Py_ssize_t index = 0; index < vertices_count; index++) {
+        /* (dd) unpacks any sequence of two numbers, lists as well */
+        PyObject *item = PySequence_Fast_GET_ITEM(seq, index);
+        if (!PyArg_Parse(item, "(dd)", &points[index].x, &points[index].y)) {
+            Py_DECREF(seq);
+            PyMem_Free(points);
+            return -1;
+        }
+    }
+    Py_DECREF(seq);
+    *pointsp = points;
+    return vertices_count;
+}
+
+/**
+ * @brief releases the input points read by parse_points
+ *
+ * @param view buffer of the points
+ * @param points the points
+ */
+static void release_points(Py_buffer *view, point_t* points) {
+    if (view->obj)
+        PyBuffer_Release(view);
+    else
+        PyMem_Free(points);
+}
+
+static PyObject *voronoi(PyObject *self, PyObject *args, PyObject *kwargs) {
+    static char *kwlist[] = {"points", "context", "clip", NULL};
+    PyObject *vertices_list, *result, *owner = Py_None, *clip = Py_None;
+    ContextObject *context;
+    Py_buffer view;
+    Py_ssize_t vertices_count;
+    int nedges;
+    segment_t* edges;
+    point_t* points;
+    box_t box, *boxp;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|OO", kwlist,
+                                     &vertices_list, &owner, &clip))
+        return NULL;
+    if (!(boxp = parse_clip(clip, &box)) && PyErr_Occurred()) return NULL;
+    if (!(context = context_acquire(owner, VORONOI_DCEL))) return NULL;
+    voronoi_ctx_clip(context->ctx, boxp);
+
+    if ((vertices_count = parse_points(vertices_list, &view, &points)) < 0) {
+        context_release(context);
+        return NULL;
+    }
+
+    /* the points are either private or locked by the buffer, and the 
+       context by its busy flag, so nothing the sweep touches is shared */
+    Py_BEGIN_ALLOW_THREADS
+    nedges = compute_voronoi(context->ctx, points, vertices_count, &edges);
+    Py_END_ALLOW_THREADS
+
+    if (nedges < 0)
+        result = PyErr_NoMemory();
+    else if (view.obj && boxp)
+        result = clipped_arrays(context, edges, nedges);
+    else if (view.obj)
+        result = voronoi_arrays(context);
+    else
+        result = parse_voronoi(edges, nedges, points);
+    release_points(&view, points);
+    context_release(context);
+    return result;
+}
+
+static PyObject *delaunay(PyObject *self, PyObject *args, PyObject *kwargs) {
+    static char *kwlist[] = {"points", "context", NULL};
+    PyObject *vertices_list, *result, *owner = Py_None;
+    ContextObject *context;
+    Py_buffer view;
+    Py_ssize_t vertices_count;
+    int nedges;
+    segment_t* edges;
+    point_t* points;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O", kwlist,
+                                     &vertices_list, &owner))
+        return NULL;
+    if (!(context = context_acquire(owner, TRIANGLE_FLAGS))) return NULL;
+    voronoi_ctx_clip(context->ctx, NULL);
+
+    if ((vertices_count = parse_points(vertices_list, &view, &points)) < 0) {
+        context_release(context);
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    nedges = compute_voronoi(context->ctx, points, vertices_count, &edges);
+    Py_END_ALLOW_THREADS
+
+    if (nedges < 0)
+        result = PyErr_NoMemory();
+    else
+        result = triangle_arrays(context);
+    release_points(&view, points);
+    context_release(context);
+    return result;
+}
+
+static PyObject *cells(PyObject *self, PyObject *args, PyObject *kwargs) {
+    static char *kwlist[] = {"points", "clip", "context", NULL};
+    PyObject *vertices_list, *result, *owner = Py_None, *clip;
+    ContextObject *context;
+    Py_buffer view;
+    Py_ssize_t vertices_count;
+    int status;
+    segment_t* edges;
+    point_t* points;
+    box_t box;
+    voronoi_polygons_t polygons;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|O", kwlist,
+                                     &vertices_list, &clip, &owner))
+        return NULL;
+    if (!parse_clip(clip, &box)) {
+        if (!PyErr_Occurred())
+            PyErr_SetString(PyExc_TypeError, "clip must not be None");
+        return NULL;
+    }
+    if (!(context = context_acquire(owner, VORONOI_DCEL))) return NULL;
+    voronoi_ctx_clip(context->ctx, &box);
+
+    if ((vertices_count = parse_points(vertices_list, &view, &points)) < 0) {
+        context_release(context);
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    status = compute_voronoi(context->ctx, points, vertices_count, &edges) < 0 ||
+             voronoi_polygons(context->ctx, points, vertices_count, &polygons);
+    Py_END_ALLOW_THREADS
+
+    if (status)
+        result = PyErr_NoMemory();
+    else
+        result = polygon_arrays(context, &polygons);
+    release_points(&view, points);
+    context_release(context);
+    return result;
+}
+
+static PyObject *voronoi_many(PyObject *self, PyObject *args,
+                              PyObject *kwargs) {
+    static char *kwlist[] = {"point_sets", "threads", NULL};
+    PyObject *point_sets, *seq, *item, *result = NULL;
+    PyObject **owners = NULL;
+    Py_buffer *views = NULL;
+    voronoi_job_t* jobs = NULL;
+    Py_ssize_t njobs, ready = 0, npoints;
+    int threads = 0, status;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|i", kwlist,
+                                     &point_sets, &threads))
+        return NULL;
+    if (!(seq = PySequence_Fast(point_sets, "point_sets must be a sequence")))
+        return NULL;
+    njobs = PySequence_Fast_GET_SIZE(seq);
+    if (njobs > INT_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "too many point sets");
+        goto done;
+    }
+    if (!(owners = PyMem_Calloc(njobs ? njobs : 1, sizeof(PyObject*))) ||
+        !(views = PyMem_Calloc(njobs ? njobs : 1, sizeof(Py_buffer))) ||
+        !(jobs = PyMem_Calloc(njobs ? njobs : 1, sizeof(voronoi_job_t)))) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    /* every diagram gets a context of its own, which its arrays keep */
+    for (; ready < njobs; ready++) {
+        item = PySequence_Fast_GET_ITEM(seq, ready);
+        if (!(owners[ready] = context_new(VORONOI_DCEL))) goto done;
+        if ((npoints = parse_points(item, &views[ready],
+                                    &jobs[ready].points)) < 0) {
+            Py_DECREF(owners[ready]);
+            goto done;
+        }
+        jobs[ready].ctx = ((ContextObject*) owners[ready])->ctx;
+        jobs[ready].npoints = npoints;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    status = compute_voronoi_many(jobs, njobs, threads);
+    Py_END_ALLOW_THREADS
+    if (status) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    if (!(result = PyList_New(njobs))) goto done;
+    for (Py_ssize_t i = 0; i < njobs; i++) {
+        if (views[i].obj)
+            item = voronoi_arrays((ContextObject*) owners[i]);
+        else
+            item = parse_voronoi(jobs[i].edges, jobs[i].nedges,
+                                 jobs[i].points);
+        if (!item) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, item);
+    }
+
+done:
+    for (Py_ssize_t i = 0; i < ready; i++) {
+        release_points(&views[i], jobs[i].points);
+        Py_DECREF(owners[i]);
+    }
+    PyMem_Free(owners);
+    PyMem_Free(views);
+    PyMem_Free(jobs);
+    Py_DECREF(seq);
+    return result;
+}
+
+static PyObject *stats(PyObject *self, PyObject *owner) {
+    voronoi_stats_t counters;
+
+    if (!PyObject_TypeCheck(owner, &ContextType)) {
+        PyErr_SetString(PyExc_TypeError, "context must be a voronoi context");
+        return NULL;
+    }
+    if (((ContextObject*) owner)->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "context is in use by another "
+                        "call");
+        return NULL;
+    }
+    if (voronoi_stats(((ContextObject*) owner)->ctx, &counters)) {
+        PyErr_SetString(PyExc_RuntimeError, "voronoi was built without "
+                        "statistics, rebuild it with make python STATS=1");
+        return NULL;
+    }
+    return Py_BuildValue("{s:l,s:l,s:l,s:l,s:l,s:d,s:i,s:i,s:i,s:l,s:d,s:d}",
+                         "site_events", counters.site_events,
+                         "circle_events", counters.circle_events,
+                         "stale_circle_events", counters.stale_circle_events,
+                         "breakpoint_tests", counters.breakpoint_tests,
+                         "searches", counters.searches,
+                         "mean_depth", counters.mean_depth,
+                         "max_depth", counters.max_depth,
+                         "max_beachline", counters.max_beachline,
+                         "max_events", counters.max_events,
+                         "allocations", counters.allocations,
+                         "site_seconds", counters.site_seconds,
+                         "circle_seconds", counters.circle_seconds);
+}
+
+char voronoifunc_docs[] = "voronoi(points, context=None, clip=None)\n\n"
+    "Computes the voronoi diagram and delaunay triangulation of points. A "
+    "float64 array of shape (N, 2) is read in place and yields the arrays "
+    "(vertices, edges, delaunay), which share memory with the context: "
+    "edges holds the two vertex indices of every voronoi edge, -1 at "
+    "infinite ends, and delaunay the indices of the two points p, q it "
+    "separates. These arrays need no separate rays: an edge (a, -1) is the "
+    "ray leaving vertex a in direction (p.y - q.y, q.x - p.x), an edge "
+    "(-1, a) the ray in the opposite direction. A list of pairs yields "
+    "lists of segments and rays. With clip=(xmin, ymin, xmax, ymax) every "
+    "edge is clipped to that rectangle, running with the first point of its "
+    "delaunay edge on its left, and there are no rays: an array yields the "
+    "arrays (segments, delaunay), where row i of the float64 array "
+    "segments holds x1, y1, x2, y2 of the edge between the points of row "
+    "i of delaunay, NaN if the edge misses the rectangle, and a list of "
+    "pairs yields lists of segments and an empty list of rays.";
+
+char cellsfunc_docs[] = "cells(points, clip, context=None)\n\n"
+    "Computes the voronoi cells of points, given like those of voronoi(), "
+    "as polygons clipped to the rectangle clip=(xmin, ymin, xmax, ymax). "
+    "Returns the arrays (vertices, bounds), which share memory with the "
+    "context: the polygon of point i is vertices[bounds[i, 0]:bounds[i, 1]],"
+    " in counterclockwise order, and empty if the cell misses the "
+    "rectangle.";
+
+char delaunayfunc_docs[] = "delaunay(points, context=None)\n\n"
+    "Computes the delaunay triangulation of points, given like those of "
+    "voronoi(), and returns the int32 arrays (triangles, neighbours) of "
+    "shape (T, 3), which share memory with the context. Every row of "
+    "triangles holds the indices of the three points of a triangle in "
+    "counterclockwise order, and the same row of neighbours the triangle "
+    "across the side opposite each of them, -1 on the convex hull. A "
+    "context must be created with context(triangles=True).";
+
+char voronoimanyfunc_docs[] = "voronoi_many(point_sets, threads=0)\n\n"
+    "Computes the diagrams of a sequence of point sets in parallel on up to "
+    "threads threads, one per processor by default, and returns the list of "
+    "what voronoi() would return for each of them.";
+
+char contextfunc_docs[] = "context(triangles=False)\n\n"
+    "Creates a context that voronoi() can reuse across calls through its "
+    "context argument, and delaunay() as well if triangles is true.";
+
+char statsfunc_docs[] = "stats(context)\n\n"
+    "Returns a dict of the counters of the last diagram computed with "
+    "context: site_events and circle_events processed, "
+    "stale_circle_events cancelled before the sweep reached them, "
+    "breakpoint_tests of sites located against a beachline boundary, "
+    "beachline searches with their mean_depth and max_depth, the peak "
+    "max_beachline and max_events sizes, pool allocations, and the "
+    "site_seconds and circle_seconds spent per event type. Only available "
+    "in modules built with make python STATS=1.";
 
 PyMethodDef voronoi_funcs[] = {
 	{	"voronoi",
 		(PyCFunction)voronoi,
-		METH_VARARGS,
+		METH_VARARGS | METH_KEYWORDS,
 		voronoifunc_docs},
+	{	"delaunay",
+		(PyCFunction)delaunay,
+		METH_VARARGS | METH_KEYWORDS,
+		delaunayfunc_docs},
+	{	"cells",
+		(PyCFunction)cells,
+		METH_VARARGS | METH_KEYWORDS,
+		cellsfunc_docs},
+	{	"voronoi_many",
+		(PyCFunction)voronoi_many,
+		METH_VARARGS | METH_KEYWORDS,
+		voronoimanyfunc_docs},
+	{	"context",
+		(PyCFunction)context,
+		METH_VARARGS | METH_KEYWORDS,
+		contextfunc_docs},
+	{	"stats",
+		(PyCFunction)stats,
+		METH_O,
+		statsfunc_docs},
 	{	NULL}
 };
 
@@ -84,6 +819,7 @@ PyModuleDef voronoi_mod = {
 };
 
 PyMODINIT_FUNC PyInit_voronoi(void) {
+	if (PyType_Ready(&ContextType) < 0 || PyType_Ready(&ArrayType) < 0)
+		return NULL;
 	return PyModule_Create(&voronoi_mod);
 }
-